@@ -0,0 +1,47 @@
+#include "common.hpp"
+#include <ice/async.hpp>
+#include <ice/channel.hpp>
+#include <ice/context.hpp>
+#include <thread>
+
+#if ICE_DEBUG
+constexpr std::size_t iterations = 10000;
+#else
+constexpr std::size_t iterations = 1000000;
+#endif
+
+// Sends values from a coroutine on the first context to a coroutine on the second context.
+static void channel_transfer(benchmark::State& state) noexcept
+{
+  ice::context c0;
+  ice::context c1;
+  ice::channel<std::size_t, 256> channel;
+
+  const auto consume = [&]() -> ice::task {
+    co_await c1.schedule(true);
+    while (co_await channel.recv(c1)) {
+    }
+    c1.stop();
+  };
+  consume();
+
+  const auto produce = [&]() -> ice::task {
+    co_await c0.schedule(true);
+    std::size_t i = 0;
+    for (auto _ : state) {
+      co_await channel.send(i++, c0);
+    }
+    channel.close();
+    c0.stop();
+  };
+  produce();
+
+  auto t1 = std::thread([&]() {
+    ice_set_thread_affinity(1);
+    c1.run();
+  });
+  ice_set_thread_affinity(0);
+  c0.run();
+  t1.join();
+}
+BENCHMARK(channel_transfer)->Threads(1)->Iterations(iterations)->UseRealTime();
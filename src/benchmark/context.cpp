@@ -1,7 +1,9 @@
 #include "common.hpp"
 #include <ice/async.hpp>
 #include <ice/context.hpp>
+#include <atomic>
 #include <thread>
+#include <vector>
 
 #if ICE_DEBUG
 constexpr std::size_t iterations = 10000;
@@ -75,10 +77,11 @@ BENCHMARK(context_switch)->Threads(1)->Iterations(iterations);
 
 // Switches to the first context.
 // Switches to the second context.
+// The argument is the number of times an idle context polls its queue before it goes to sleep.
 static void context_always(benchmark::State& state) noexcept
 {
-  ice::context c0;
-  ice::context c1;
+  ice::context c0{ static_cast<std::size_t>(state.range(0)) };
+  ice::context c1{ static_cast<std::size_t>(state.range(0)) };
   auto t0 = std::thread([&]() {
     ice_set_thread_affinity(0);
     c0.run();
@@ -105,4 +108,42 @@ static void context_always(benchmark::State& state) noexcept
   t0.join();
   t1.join();
 }
-BENCHMARK(context_always)->Threads(1)->Iterations(iterations);
+BENCHMARK(context_always)->Arg(0)->Arg(1000)->Threads(1)->Iterations(iterations);
+
+// Posts to a context that is running on another thread from multiple producer threads.
+static void context_post(benchmark::State& state) noexcept
+{
+  constexpr std::size_t posts = 10000;
+  const auto producers = static_cast<std::size_t>(state.range(0));
+  ice::context c0;
+  auto t0 = std::thread([&]() {
+    ice_set_thread_affinity(0);
+    c0.run();
+  });
+  std::atomic_size_t count = 0;
+  const auto task = [&]() -> ice::task {
+    co_await c0.schedule(true);
+    count.fetch_add(1, std::memory_order_release);
+  };
+  for (auto _ : state) {
+    count.store(0, std::memory_order_relaxed);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < producers; i++) {
+      threads.emplace_back([&task]() {
+        for (std::size_t i = 0; i < posts; i++) {
+          task();
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    while (count.load(std::memory_order_acquire) < producers * posts) {
+      std::this_thread::yield();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * producers * posts);
+  c0.stop();
+  t0.join();
+}
+BENCHMARK(context_post)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
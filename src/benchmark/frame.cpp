@@ -0,0 +1,121 @@
+#include "common.hpp"
+#include <ice/async.hpp>
+#include <ice/error.hpp>
+#include <ice/frame.hpp>
+#include <ice/net/service.hpp>
+#include <ice/net/tcp/socket.hpp>
+#include <array>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+#if ICE_DEBUG
+constexpr std::size_t iterations = 10000;
+#else
+constexpr std::size_t iterations = 100000;
+#endif
+
+namespace {
+
+std::atomic_size_t g_allocations = 0;
+
+}  // namespace
+
+// Counts global heap allocations. This benchmark is built as a separate executable, so that the counter does not slow
+// down the allocations of the other benchmarks.
+void* operator new(std::size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  const auto data = std::malloc(size ? size : 1);
+  if (!data) {
+    ice::throw_exception(std::bad_alloc());
+  }
+  return data;
+}
+
+void operator delete(void* data) noexcept
+{
+  std::free(data);
+}
+
+void operator delete(void* data, std::size_t) noexcept
+{
+  std::free(data);
+}
+
+// Sends and receives one byte over a loopback connection and reports the heap allocations per round trip.
+// The first argument selects the thread local pool (0) or a per-connection frame arena (1).
+static void frame_echo(benchmark::State& state) noexcept
+{
+  ice::net::service c0;
+  if (const auto ec = c0.create()) {
+    state.SkipWithError(ec.message().data());
+    return;
+  }
+
+  const auto arena = state.range(0) != 0;
+  ice::frame_arena client_arena;
+  ice::frame_arena server_arena;
+  ice::net::tcp::socket server{ c0 };
+  ice::net::tcp::socket client{ c0 };
+
+  const auto serve = [&]() -> ice::task {
+    ice::net::endpoint remote;
+    auto socket = co_await server.accept(remote);
+    if (arena) {
+      socket.arena(&server_arena);
+    }
+    std::array<char, 64> buffer;
+    std::error_code ec;
+    while (true) {
+      const auto size = co_await socket.recv(buffer.data(), buffer.size(), ec);
+      if (ec || !size) {
+        break;
+      }
+      co_await socket.send(buffer.data(), size, ec);
+    }
+  };
+
+  const auto main = [&]() -> ice::task {
+    const auto ose = ice::on_scope_exit([&]() { c0.stop(); });
+    ice::net::endpoint ep;
+    if (const auto ec = ep.create("127.0.0.1", 0)) {
+      state.SkipWithError(ec.message().data());
+      co_return;
+    }
+    if (server.create(ep.family()) || server.bind(ep) || server.listen()) {
+      state.SkipWithError("could not create server");
+      co_return;
+    }
+    ep = server.name();
+    serve();
+    if (client.create(ep.family()) || co_await client.connect(ep)) {
+      state.SkipWithError("could not connect");
+      co_return;
+    }
+    if (arena) {
+      client.arena(&client_arena);
+    }
+    std::array<char, 64> buffer;
+    std::error_code ec;
+    const auto c = 'x';
+    co_await client.send(&c, 1, ec);
+    co_await client.recv(buffer.data(), buffer.size(), ec);
+    const auto allocations = g_allocations.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+      co_await client.send(&c, 1, ec);
+      co_await client.recv(buffer.data(), buffer.size(), ec);
+    }
+    state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(g_allocations.load(std::memory_order_relaxed) - allocations),
+      benchmark::Counter::kAvgIterations);
+    client.close();
+    co_await c0.schedule(true);
+  };
+  main();
+
+  ice_set_thread_affinity(0);
+  c0.run();
+  server.close();
+}
+BENCHMARK(frame_echo)->Threads(1)->Iterations(iterations)->Arg(0)->Arg(1);
@@ -0,0 +1,84 @@
+#include "common.hpp"
+#include <ice/async.hpp>
+#include <atomic>
+#include <thread>
+
+#if ICE_DEBUG
+constexpr std::size_t iterations = 10000;
+#else
+constexpr std::size_t iterations = 100000;
+#endif
+
+namespace {
+
+// Every benchmark thread modifies the table once per this many reads.
+constexpr std::size_t writes = 1024;
+
+struct table {
+  std::atomic_size_t value = 0;
+};
+
+// Runs the coroutine and waits until it completed on this or another thread.
+template <typename Function>
+void run(Function& function)
+{
+  std::atomic_bool done = false;
+  function(done);
+  while (!done.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace
+
+// Reads a table protected by an exclusive mutex.
+static void mutex_read(benchmark::State& state) noexcept
+{
+  static ice::async_mutex mutex;
+  static table table;
+  const auto read = [&](std::atomic_bool& done) -> ice::task {
+    const auto lock = co_await mutex.scoped_lock_async();
+    benchmark::DoNotOptimize(table.value.load(std::memory_order_relaxed));
+    done.store(true, std::memory_order_release);
+  };
+  const auto write = [&](std::atomic_bool& done) -> ice::task {
+    const auto lock = co_await mutex.scoped_lock_async();
+    table.value.fetch_add(1, std::memory_order_relaxed);
+    done.store(true, std::memory_order_release);
+  };
+  std::size_t i = 0;
+  for (auto _ : state) {
+    if (++i % writes) {
+      run(read);
+    } else {
+      run(write);
+    }
+  }
+}
+BENCHMARK(mutex_read)->Iterations(iterations)->ThreadRange(1, 16)->UseRealTime();
+
+// Reads a table protected by a shared mutex.
+static void shared_mutex_read(benchmark::State& state) noexcept
+{
+  static ice::async_shared_mutex mutex;
+  static table table;
+  const auto read = [&](std::atomic_bool& done) -> ice::task {
+    const auto lock = co_await mutex.scoped_lock_shared_async();
+    benchmark::DoNotOptimize(table.value.load(std::memory_order_relaxed));
+    done.store(true, std::memory_order_release);
+  };
+  const auto write = [&](std::atomic_bool& done) -> ice::task {
+    const auto lock = co_await mutex.scoped_lock_async();
+    table.value.fetch_add(1, std::memory_order_relaxed);
+    done.store(true, std::memory_order_release);
+  };
+  std::size_t i = 0;
+  for (auto _ : state) {
+    if (++i % writes) {
+      run(read);
+    } else {
+      run(write);
+    }
+  }
+}
+BENCHMARK(shared_mutex_read)->Iterations(iterations)->ThreadRange(1, 16)->UseRealTime();
@@ -1,7 +1,12 @@
 #include "common.hpp"
 #include <ice/async.hpp>
 #include <ice/net/service.hpp>
+#include <ice/net/tcp/socket.hpp>
+#include <ice/sync_wait.hpp>
+#include <array>
+#include <atomic>
 #include <thread>
+#include <vector>
 
 #if ICE_DEBUG
 constexpr std::size_t iterations = 10000;
@@ -131,3 +136,241 @@ static void service_always(benchmark::State& state) noexcept
   t1.join();
 }
 BENCHMARK(service_always)->Threads(1)->Iterations(iterations);
+
+// Posts to a service that is running on another thread.
+static void service_post(benchmark::State& state) noexcept
+{
+  ice::net::service c0;
+  if (const auto ec = c0.create()) {
+    state.SkipWithError(ec.message().data());
+    return;
+  }
+  auto t0 = std::thread([&]() {
+    ice_set_thread_affinity(0);
+    c0.run();
+  });
+  ice_set_thread_affinity(1);
+  std::atomic_size_t count = 0;
+  for (auto _ : state) {
+    [](ice::net::service& c0, std::atomic_size_t& count) -> ice::task {
+      co_await c0.schedule(true);
+      count.fetch_add(1, std::memory_order_release);
+    }(c0, count);
+  }
+  while (count.load(std::memory_order_acquire) < static_cast<std::size_t>(state.iterations())) {
+    std::this_thread::yield();
+  }
+  c0.stop();
+  t0.join();
+}
+BENCHMARK(service_post)->Threads(1)->Iterations(iterations);
+
+// Echoes messages over multiple connections on a service that is running on multiple threads.
+static void service_echo(benchmark::State& state) noexcept
+{
+  constexpr std::size_t connections = 64;
+  constexpr std::size_t messages = 100;
+
+  ice::net::service c0;
+  if (const auto ec = c0.create()) {
+    state.SkipWithError(ec.message().data());
+    return;
+  }
+
+  ice::net::endpoint ep;
+  ice::net::tcp::socket server{ c0 };
+  if (const auto ec = ep.create("127.0.0.1", 0)) {
+    state.SkipWithError(ec.message().data());
+    return;
+  }
+  if (auto ec = server.create(ep.family()); ec || (ec = server.bind(ep)) || (ec = server.listen())) {
+    state.SkipWithError(ec.message().data());
+    return;
+  }
+  ep = server.name();
+
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < state.range(0); i++) {
+    threads.emplace_back([&c0, i]() {
+      ice_set_thread_affinity(static_cast<std::size_t>(i));
+      c0.run();
+    });
+  }
+
+  std::atomic_size_t done = 0;
+  const auto serve = [&](ice::net::tcp::socket socket) -> ice::task {
+    std::array<char, 64> buffer;
+    std::error_code ec;
+    while (true) {
+      const auto size = co_await socket.recv(buffer.data(), buffer.size(), ec);
+      if (ec || !size || co_await socket.send(buffer.data(), size, ec) != size) {
+        break;
+      }
+    }
+    done.fetch_add(1, std::memory_order_release);
+  };
+  const auto accept = [&]() -> ice::task {
+    co_await c0.schedule(true);
+    for (std::size_t i = 0; i < connections; i++) {
+      ice::net::endpoint remote;
+      serve(co_await server.accept(remote));
+    }
+  };
+  accept();
+
+  std::vector<ice::net::tcp::socket> clients;
+  clients.reserve(connections);
+  for (std::size_t i = 0; i < connections; i++) {
+    clients.emplace_back(c0);
+  }
+  const auto connect = [&](ice::net::tcp::socket& client) -> ice::task {
+    co_await c0.schedule(true);
+    if (!client.create(ep.family())) {
+      co_await client.connect(ep);
+    }
+    done.fetch_add(1, std::memory_order_release);
+  };
+  for (auto& client : clients) {
+    connect(client);
+  }
+  const auto wait = [&](std::size_t count) {
+    while (done.load(std::memory_order_acquire) < count) {
+      std::this_thread::yield();
+    }
+    done.store(0, std::memory_order_relaxed);
+  };
+  wait(connections);
+
+  // Every iteration sends a batch of messages over each connection and waits for the replies.
+  const auto echo = [&](ice::net::tcp::socket& client) -> ice::task {
+    co_await c0.schedule(true);
+    std::array<char, 64> buffer = {};
+    std::error_code ec;
+    for (std::size_t i = 0; i < messages; i++) {
+      if (co_await client.send(buffer.data(), buffer.size(), ec) != buffer.size()) {
+        break;
+      }
+      auto size = std::size_t(0);
+      while (size < buffer.size()) {
+        const auto rv = co_await client.recv(buffer.data() + size, buffer.size() - size, ec);
+        if (ec || !rv) {
+          break;
+        }
+        size += rv;
+      }
+      if (size < buffer.size()) {
+        break;
+      }
+    }
+    done.fetch_add(1, std::memory_order_release);
+  };
+  for (auto _ : state) {
+    for (auto& client : clients) {
+      echo(client);
+    }
+    wait(connections);
+  }
+  state.SetItemsProcessed(state.iterations() * connections * messages);
+
+  for (auto& client : clients) {
+    client.close();
+  }
+  wait(connections);
+  c0.stop();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+BENCHMARK(service_echo)->DenseRange(1, 8)->UseRealTime();
+
+// Sends a request from a blocked thread to a server on a service thread and waits for the response.
+static void service_request(benchmark::State& state) noexcept
+{
+  ice::net::service c0;
+  if (const auto ec = c0.create()) {
+    state.SkipWithError(ec.message().data());
+    return;
+  }
+
+  ice::net::endpoint ep;
+  ice::net::tcp::socket server{ c0 };
+  if (const auto ec = ep.create("127.0.0.1", 0)) {
+    state.SkipWithError(ec.message().data());
+    return;
+  }
+  if (auto ec = server.create(ep.family()); ec || (ec = server.bind(ep)) || (ec = server.listen())) {
+    state.SkipWithError(ec.message().data());
+    return;
+  }
+  ep = server.name();
+
+  auto t0 = std::thread([&]() {
+    ice_set_thread_affinity(0);
+    c0.run();
+  });
+  ice_set_thread_affinity(1);
+
+  std::atomic_bool done = false;
+  const auto serve = [&]() -> ice::task {
+    co_await c0.schedule(true);
+    ice::net::endpoint remote;
+    auto socket = co_await server.accept(remote);
+    std::array<char, 64> buffer;
+    std::error_code ec;
+    while (true) {
+      const auto size = co_await socket.recv(buffer.data(), buffer.size(), ec);
+      if (ec || !size || co_await socket.send(buffer.data(), size, ec) != size) {
+        break;
+      }
+    }
+    done.store(true, std::memory_order_release);
+  };
+  serve();
+
+  ice::net::tcp::socket client{ c0 };
+  const auto connect = [&]() -> ice::async<std::error_code> {
+    co_await c0.schedule(true);
+    if (const auto ec = client.create(ep.family())) {
+      co_return ec;
+    }
+    co_return co_await client.connect(ep);
+  };
+  if (const auto ec = ice::sync_wait(connect())) {
+    state.SkipWithError(ec.message().data());
+    c0.stop();
+    t0.join();
+    return;
+  }
+
+  const auto request = [&]() -> ice::async<bool> {
+    co_await c0.schedule(true);
+    std::array<char, 64> buffer = {};
+    std::error_code ec;
+    if (co_await client.send(buffer.data(), buffer.size(), ec) != buffer.size()) {
+      co_return false;
+    }
+    auto size = std::size_t(0);
+    while (size < buffer.size()) {
+      const auto rv = co_await client.recv(buffer.data() + size, buffer.size() - size, ec);
+      if (ec || !rv) {
+        co_return false;
+      }
+      size += rv;
+    }
+    co_return true;
+  };
+  for (auto _ : state) {
+    if (!ice::sync_wait(request())) {
+      state.SkipWithError("request failed");
+      break;
+    }
+  }
+
+  client.close();
+  while (!done.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+  c0.stop();
+  t0.join();
+}
+BENCHMARK(service_request)->Threads(1)->Iterations(iterations)->UseRealTime();
@@ -0,0 +1,74 @@
+#include "common.hpp"
+#include <ice/async.hpp>
+#include <ice/thread_pool.hpp>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+
+#if ICE_DEBUG
+constexpr std::size_t iterations = 10000;
+#else
+constexpr std::size_t iterations = 1000000;
+#endif
+
+// Switches to the current worker (suspends execution).
+static void thread_pool_append(benchmark::State& state) noexcept
+{
+  ice::thread_pool pool;
+  if (const auto ec = pool.create(1)) {
+    state.SkipWithError(ec.message().data());
+    return;
+  }
+  std::atomic_bool done = false;
+  [](ice::thread_pool& pool, benchmark::State& state, std::atomic_bool& done) -> ice::task {
+    co_await pool.schedule();
+    for (auto _ : state) {
+      co_await pool.schedule(true);
+    }
+    done.store(true, std::memory_order_release);
+  }(pool, state, done);
+  while (!done.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+  pool.stop();
+  pool.join();
+}
+BENCHMARK(thread_pool_append)->Threads(1)->Iterations(iterations);
+
+// Spreads coroutines that are spawned on one worker over all workers.
+static void thread_pool_spawn(benchmark::State& state) noexcept
+{
+  constexpr std::size_t tasks = 1024;
+  ice::thread_pool pool;
+  if (const auto ec = pool.create(static_cast<std::size_t>(state.range(0)))) {
+    state.SkipWithError(ec.message().data());
+    return;
+  }
+  std::atomic_size_t done = 0;
+  const auto task = [&]() -> ice::task {
+    co_await pool.schedule(true);
+    auto value = std::uint32_t(0);
+    for (std::uint32_t i = 0; i < 1000; i++) {
+      value = value * 31 + i;
+    }
+    benchmark::DoNotOptimize(value);
+    done.fetch_add(1, std::memory_order_release);
+  };
+  const auto spawn = [&]() -> ice::task {
+    co_await pool.schedule();
+    for (std::size_t i = 0; i < tasks; i++) {
+      task();
+    }
+  };
+  for (auto _ : state) {
+    done.store(0, std::memory_order_relaxed);
+    spawn();
+    while (done.load(std::memory_order_acquire) < tasks) {
+      std::this_thread::yield();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * tasks);
+  pool.stop();
+  pool.join();
+}
+BENCHMARK(thread_pool_spawn)->DenseRange(1, 8)->UseRealTime();
@@ -0,0 +1,78 @@
+#include "common.hpp"
+#include <ice/async.hpp>
+#include <ice/error.hpp>
+#include <ice/net/service.hpp>
+#include <ice/net/udp/socket.hpp>
+#include <array>
+
+#if ICE_DEBUG
+constexpr std::size_t iterations = 10000;
+#else
+constexpr std::size_t iterations = 100000;
+#endif
+
+// Sends and receives a burst of small datagrams over loopback.
+// The first argument selects one system call per datagram (0) or batched operations (1).
+static void udp_burst(benchmark::State& state) noexcept
+{
+  constexpr std::size_t count = 32;
+
+  ice::net::service c0;
+  if (const auto ec = c0.create()) {
+    state.SkipWithError(ec.message().data());
+    return;
+  }
+
+  const auto batch = state.range(0) != 0;
+  ice::net::udp::socket server{ c0 };
+  ice::net::udp::socket client{ c0 };
+
+  const auto main = [&]() -> ice::task {
+    const auto ose = ice::on_scope_exit([&]() { c0.stop(); });
+    ice::net::endpoint ep;
+    if (const auto ec = ep.create("127.0.0.1", 0)) {
+      state.SkipWithError(ec.message().data());
+      co_return;
+    }
+    if (server.create(ep.family()) || server.bind(ep) || client.create(ep.family())) {
+      state.SkipWithError("could not create sockets");
+      co_return;
+    }
+    ep = server.name();
+    std::array<std::array<char, 64>, count> buffers = {};
+    std::array<ice::net::udp::datagram, count> send;
+    std::array<ice::net::udp::datagram, count> recv;
+    for (std::size_t i = 0; i < count; i++) {
+      send[i].buffer = { buffers[i].data(), buffers[i].size() };
+      send[i].endpoint = ep;
+      recv[i].buffer = { buffers[i].data(), buffers[i].size() };
+    }
+    std::error_code ec;
+    for (auto _ : state) {
+      if (batch) {
+        co_await client.send_to(send, ec);
+        for (std::size_t received = 0; received < count && !ec;) {
+          received += co_await server.recv_from(std::span(recv).subspan(received), ec);
+        }
+      } else {
+        for (std::size_t i = 0; i < count; i++) {
+          co_await client.send_to(buffers[i].data(), buffers[i].size(), ep, ec);
+        }
+        for (std::size_t i = 0; i < count && !ec; i++) {
+          co_await server.recv_from(buffers[i].data(), buffers[i].size(), recv[i].endpoint, ec);
+        }
+      }
+      if (ec) {
+        state.SkipWithError(ec.message().data());
+        break;
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    co_await c0.schedule(true);
+  };
+  main();
+
+  ice_set_thread_affinity(0);
+  c0.run();
+}
+BENCHMARK(udp_burst)->Threads(1)->Iterations(iterations / 10)->Arg(0)->Arg(1);
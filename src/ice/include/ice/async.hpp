@@ -23,7 +23,11 @@
 #pragma once
 #include <ice/config.hpp>
 #include <ice/error.hpp>
+#include <ice/frame.hpp>
 #include <ice/result.hpp>
+#include <ice/synchronization.hpp>
+#include <ice/utility.hpp>
+#include <array>
 #include <atomic>
 #include <coroutine>
 #include <iterator>
@@ -43,7 +47,7 @@
 namespace ice {
 
 struct task {
-  struct promise_type {
+  struct promise_type : frame_allocator {
     constexpr task get_return_object() const noexcept
     {
       return {};
@@ -279,7 +283,8 @@ namespace detail {
 
 class continuation {
 public:
-  using callback_t = void(void*);
+  // Returns the coroutine that should be resumed next or std::noop_coroutine().
+  using callback_t = std::coroutine_handle<>(void*);
 
   continuation() noexcept = default;
 
@@ -295,12 +300,16 @@ public:
   }
 
   void resume() noexcept
+  {
+    handle().resume();
+  }
+
+  std::coroutine_handle<> handle() noexcept
   {
     if (m_callback == nullptr) {
-      std::coroutine_handle<>::from_address(m_state).resume();
-    } else {
-      m_callback(m_state);
+      return std::coroutine_handle<>::from_address(m_state);
     }
+    return m_callback(m_state);
   }
 
 private:
@@ -317,7 +326,7 @@ class async;
 
 namespace detail {
 
-class async_promise_base {
+class async_promise_base : public frame_allocator {
   friend struct final_awaitable;
 
   struct final_awaitable {
@@ -327,12 +336,15 @@ class async_promise_base {
     }
 
     template <typename PROMISE>
-    void await_suspend(std::coroutine_handle<PROMISE> coroutine)
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<PROMISE> coroutine) noexcept
     {
+      // The continuation of an awaited task is set before the task starts and does not need the exchange.
       async_promise_base& promise = coroutine.promise();
-      if (promise.m_state.exchange(true, std::memory_order_acq_rel)) {
-        promise.m_continuation.resume();
+      auto& state = promise.m_state;
+      if (state.load(std::memory_order_acquire) || state.exchange(true, std::memory_order_acq_rel)) {
+        return promise.m_continuation.handle();
       }
+      return std::noop_coroutine();
     }
 
     void await_resume() noexcept {}
@@ -360,6 +372,13 @@ public:
   }
 #endif
 
+  // Sets the continuation of a task that did not start yet.
+  void set_continuation(continuation c) noexcept
+  {
+    m_continuation = c;
+    m_state.store(true, std::memory_order_relaxed);
+  }
+
   bool try_set_continuation(continuation c)
   {
     m_continuation = c;
@@ -502,10 +521,11 @@ private:
       return !m_coroutine || m_coroutine.done();
     }
 
-    bool await_suspend(std::coroutine_handle<> awaiter) noexcept
+    // Transfers to the task, which transfers back to the awaiter when it completes.
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept
     {
-      m_coroutine.resume();
-      return m_coroutine.promise().try_set_continuation(detail::continuation{ awaiter });
+      m_coroutine.promise().set_continuation(detail::continuation{ awaiter });
+      return m_coroutine;
     }
   };
 
@@ -1087,14 +1107,32 @@ class async_mutex_lock;
 class async_mutex_lock_operation;
 class async_mutex_scoped_lock_operation;
 
+template <typename Scheduler>
+class async_mutex_lock_on_operation;
+
+template <typename Scheduler>
+class async_mutex_scoped_lock_on_operation;
+
+// Waiters that lock the mutex with a scheduler are posted back to that scheduler by unlock instead of being resumed
+// on the unlocking thread. Up to batch consecutive waiters on the scheduler of the unlocking thread are resumed
+// inline, which saves the round trip through the scheduler queue but lets the stack grow.
+// Lock operations do not take a cancellation token, because waiters are pushed onto a lock free stack that does not
+// support removal.
 class async_mutex {
 public:
-  async_mutex() noexcept = default;
+  explicit async_mutex(std::size_t batch = 0) noexcept : m_batch(batch) {}
   ~async_mutex();
 
   bool try_lock() noexcept;
   async_mutex_lock_operation lock_async() noexcept;
   async_mutex_scoped_lock_operation scoped_lock_async() noexcept;
+
+  template <typename Scheduler>
+  async_mutex_lock_on_operation<Scheduler> lock_async(Scheduler& scheduler) noexcept;
+
+  template <typename Scheduler>
+  async_mutex_scoped_lock_on_operation<Scheduler> scoped_lock_async(Scheduler& scheduler) noexcept;
+
   void unlock();
 
 private:
@@ -1104,6 +1142,8 @@ private:
   static constexpr std::uintptr_t locked_no_waiters = 0;
   std::atomic<std::uintptr_t> m_state = not_locked;
   async_mutex_lock_operation* m_waiters = nullptr;
+  const std::size_t m_batch = 0;
+  std::size_t m_handoffs = 0;
 };
 
 class async_mutex_lock {
@@ -1145,11 +1185,16 @@ public:
 protected:
   friend class async_mutex;
 
+  using current_type = bool (*)(const async_mutex_lock_operation& operation) noexcept;
+  using post_type = void (*)(async_mutex_lock_operation& operation) noexcept;
+
   async_mutex& m_mutex;
+  std::coroutine_handle<> m_awaiter;
+  current_type m_current = nullptr;
+  post_type m_post = nullptr;
 
 private:
   async_mutex_lock_operation* m_next;
-  std::coroutine_handle<> m_awaiter;
 };
 
 class async_mutex_scoped_lock_operation : public async_mutex_lock_operation {
@@ -1162,6 +1207,43 @@ public:
   }
 };
 
+template <typename Scheduler>
+class async_mutex_lock_on_operation : public async_mutex_lock_operation {
+public:
+  async_mutex_lock_on_operation(async_mutex& mutex, Scheduler& scheduler) noexcept :
+    async_mutex_lock_operation(mutex), m_scheduler(scheduler), m_schedule(scheduler, true)
+  {
+    m_current = current;
+    m_post = post;
+  }
+
+private:
+  static bool current(const async_mutex_lock_operation& operation) noexcept
+  {
+    return static_cast<const async_mutex_lock_on_operation&>(operation).m_scheduler.is_current();
+  }
+
+  static void post(async_mutex_lock_operation& operation) noexcept
+  {
+    auto& self = static_cast<async_mutex_lock_on_operation&>(operation);
+    self.m_schedule.await_suspend(self.m_awaiter);
+  }
+
+  Scheduler& m_scheduler;
+  ice::schedule<Scheduler> m_schedule;
+};
+
+template <typename Scheduler>
+class async_mutex_scoped_lock_on_operation : public async_mutex_lock_on_operation<Scheduler> {
+public:
+  using async_mutex_lock_on_operation<Scheduler>::async_mutex_lock_on_operation;
+
+  [[nodiscard]] async_mutex_lock await_resume() const noexcept
+  {
+    return async_mutex_lock{ this->m_mutex, std::adopt_lock };
+  }
+};
+
 // == lib/async_mutex.cpp =============================================================================================
 
 inline async_mutex::~async_mutex()
@@ -1188,11 +1270,24 @@ inline async_mutex_scoped_lock_operation async_mutex::scoped_lock_async() noexce
   return async_mutex_scoped_lock_operation{ *this };
 }
 
+template <typename Scheduler>
+inline async_mutex_lock_on_operation<Scheduler> async_mutex::lock_async(Scheduler& scheduler) noexcept
+{
+  return async_mutex_lock_on_operation<Scheduler>{ *this, scheduler };
+}
+
+template <typename Scheduler>
+inline async_mutex_scoped_lock_on_operation<Scheduler> async_mutex::scoped_lock_async(Scheduler& scheduler) noexcept
+{
+  return async_mutex_scoped_lock_on_operation<Scheduler>{ *this, scheduler };
+}
+
 inline void async_mutex::unlock()
 {
   assert(m_state.load(std::memory_order_relaxed) != not_locked);
   async_mutex_lock_operation* waitersHead = m_waiters;
   if (waitersHead == nullptr) {
+    m_handoffs = 0;
     auto oldState = locked_no_waiters;
     const bool releasedLock =
       m_state.compare_exchange_strong(oldState, not_locked, std::memory_order_release, std::memory_order_relaxed);
@@ -1211,6 +1306,15 @@ inline void async_mutex::unlock()
   }
   assert(waitersHead != nullptr);
   m_waiters = waitersHead->m_next;
+  if (waitersHead->m_post) {
+    if (m_handoffs < m_batch && waitersHead->m_current(*waitersHead)) {
+      m_handoffs++;
+    } else {
+      m_handoffs = 0;
+      waitersHead->m_post(*waitersHead);
+      return;
+    }
+  }
   waitersHead->m_awaiter.resume();
 }
 
@@ -1234,6 +1338,299 @@ inline bool async_mutex_lock_operation::await_suspend(std::coroutine_handle<> aw
   }
 }
 
+// == async_shared_mutex ==============================================================================================
+
+class async_shared_mutex;
+
+class async_shared_mutex_lock {
+public:
+  explicit async_shared_mutex_lock(async_shared_mutex& mutex, std::adopt_lock_t) noexcept : m_mutex(&mutex) {}
+
+  async_shared_mutex_lock(async_shared_mutex_lock&& other) noexcept : m_mutex(std::exchange(other.m_mutex, nullptr))
+  {}
+
+  async_shared_mutex_lock(const async_shared_mutex_lock& other) = delete;
+  async_shared_mutex_lock& operator=(const async_shared_mutex_lock& other) = delete;
+
+  ~async_shared_mutex_lock();
+
+private:
+  async_shared_mutex* m_mutex;
+};
+
+class async_shared_mutex_lock_shared {
+public:
+  explicit async_shared_mutex_lock_shared(async_shared_mutex& mutex, std::size_t slot, std::adopt_lock_t) noexcept :
+    m_mutex(&mutex), m_slot(slot)
+  {}
+
+  async_shared_mutex_lock_shared(async_shared_mutex_lock_shared&& other) noexcept :
+    m_mutex(std::exchange(other.m_mutex, nullptr)), m_slot(other.m_slot)
+  {}
+
+  async_shared_mutex_lock_shared(const async_shared_mutex_lock_shared& other) = delete;
+  async_shared_mutex_lock_shared& operator=(const async_shared_mutex_lock_shared& other) = delete;
+
+  ~async_shared_mutex_lock_shared();
+
+private:
+  async_shared_mutex* m_mutex;
+  std::size_t m_slot;
+};
+
+// Reader-writer mutex for data that is read by many coroutines and rarely modified.
+// Readers increment one of several cache line sized counters that is selected by the current thread and only check
+// that no writer is present, so that readers on different threads do not contend. A writer announces itself and
+// waits until all counters dropped to zero. Readers that arrive while a writer is present are queued and admitted
+// together when the writer unlocks, before the next queued writer.
+// Lock operations can not be canceled. A waiter owns the mutex as soon as it is dequeued, so a canceled waiter would
+// have to be resumed with an empty lock that every caller needs to check.
+class async_shared_mutex {
+public:
+  static constexpr std::size_t slots = 16;
+
+  template <typename Scheduler>
+  class lock_operation : public detail::async_waiter_base<Scheduler> {
+  public:
+    template <typename... Args>
+    explicit lock_operation(async_shared_mutex& mutex, Args&... scheduler) noexcept :
+      detail::async_waiter_base<Scheduler>(scheduler...), m_mutex(mutex)
+    {}
+
+    constexpr bool await_ready() const noexcept
+    {
+      return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiter) noexcept
+    {
+      this->awaiter = awaiter;
+      return m_mutex.suspend(*this);
+    }
+
+    [[nodiscard]] async_shared_mutex_lock await_resume() const noexcept
+    {
+      return async_shared_mutex_lock{ m_mutex, std::adopt_lock };
+    }
+
+  private:
+    async_shared_mutex& m_mutex;
+  };
+
+  template <typename Scheduler>
+  class lock_shared_operation : public detail::async_waiter_base<Scheduler> {
+  public:
+    template <typename... Args>
+    explicit lock_shared_operation(async_shared_mutex& mutex, Args&... scheduler) noexcept :
+      detail::async_waiter_base<Scheduler>(scheduler...), m_mutex(mutex), m_slot(async_shared_mutex::slot())
+    {}
+
+    bool await_ready() noexcept
+    {
+      return m_mutex.try_lock_shared(m_slot);
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiter) noexcept
+    {
+      this->awaiter = awaiter;
+      return m_mutex.suspend_shared(*this, m_slot);
+    }
+
+    [[nodiscard]] async_shared_mutex_lock_shared await_resume() const noexcept
+    {
+      return async_shared_mutex_lock_shared{ m_mutex, m_slot, std::adopt_lock };
+    }
+
+  private:
+    async_shared_mutex& m_mutex;
+    std::size_t m_slot;
+  };
+
+  async_shared_mutex() noexcept = default;
+
+  async_shared_mutex(async_shared_mutex&& other) = delete;
+  async_shared_mutex(const async_shared_mutex& other) = delete;
+  async_shared_mutex& operator=(async_shared_mutex&& other) = delete;
+  async_shared_mutex& operator=(const async_shared_mutex& other) = delete;
+
+  ~async_shared_mutex()
+  {
+    assert(!m_writer.load(std::memory_order_relaxed));
+    assert(!readers());
+  }
+
+  // Acquires exclusive ownership and resumes on the thread that released the mutex if it has to wait.
+  lock_operation<void> scoped_lock_async() noexcept
+  {
+    return lock_operation<void>{ *this };
+  }
+
+  // Acquires exclusive ownership and resumes on the given scheduler if it has to wait.
+  template <typename Scheduler>
+  lock_operation<Scheduler> scoped_lock_async(Scheduler& scheduler) noexcept
+  {
+    return lock_operation<Scheduler>{ *this, scheduler };
+  }
+
+  // Acquires shared ownership and resumes on the thread that released the mutex if it has to wait.
+  lock_shared_operation<void> scoped_lock_shared_async() noexcept
+  {
+    return lock_shared_operation<void>{ *this };
+  }
+
+  // Acquires shared ownership and resumes on the given scheduler if it has to wait.
+  template <typename Scheduler>
+  lock_shared_operation<Scheduler> scoped_lock_shared_async(Scheduler& scheduler) noexcept
+  {
+    return lock_shared_operation<Scheduler>{ *this, scheduler };
+  }
+
+  void unlock() noexcept;
+  void unlock_shared(std::size_t slot) noexcept;
+
+private:
+  struct alignas(64) counter {
+    std::atomic_size_t value = 0;
+  };
+
+  // Counter of readers that were admitted by a writer.
+  static constexpr std::size_t admitted = slots;
+
+  static std::size_t slot() noexcept
+  {
+    static std::atomic_size_t next = 0;
+    thread_local const auto index = next.fetch_add(1, std::memory_order_relaxed) % slots;
+    return index;
+  }
+
+  std::size_t readers() const noexcept
+  {
+    std::size_t count = 0;
+    for (const auto& counter : m_readers) {
+      count += counter.value.load(std::memory_order_seq_cst);
+    }
+    return count;
+  }
+
+  bool try_lock_shared(std::size_t slot) noexcept;
+  bool suspend(detail::async_waiter& waiter) noexcept;
+  bool suspend_shared(detail::async_waiter& waiter, std::size_t& slot) noexcept;
+
+  static void push(detail::async_waiter*& head, detail::async_waiter*& tail, detail::async_waiter& waiter) noexcept
+  {
+    waiter.next = nullptr;
+    if (tail) {
+      tail->next = &waiter;
+    } else {
+      head = &waiter;
+    }
+    tail = &waiter;
+  }
+
+  std::array<counter, slots + 1> m_readers;
+  std::atomic_bool m_writer = false;
+  detail::async_waiter* m_pending = nullptr;
+  detail::async_waiter* m_writersHead = nullptr;
+  detail::async_waiter* m_writersTail = nullptr;
+  detail::async_waiter* m_readersHead = nullptr;
+  detail::async_waiter* m_readersTail = nullptr;
+  spin_lock m_lock;
+};
+
+inline async_shared_mutex_lock::~async_shared_mutex_lock()
+{
+  if (m_mutex != nullptr) {
+    m_mutex->unlock();
+  }
+}
+
+inline async_shared_mutex_lock_shared::~async_shared_mutex_lock_shared()
+{
+  if (m_mutex != nullptr) {
+    m_mutex->unlock_shared(m_slot);
+  }
+}
+
+inline bool async_shared_mutex::try_lock_shared(std::size_t slot) noexcept
+{
+  // Sequentially consistent, so that either the reader sees the writer or the writer sees the reader.
+  m_readers[slot].value.fetch_add(1, std::memory_order_seq_cst);
+  if (!m_writer.load(std::memory_order_seq_cst)) {
+    return true;
+  }
+  unlock_shared(slot);
+  return false;
+}
+
+inline void async_shared_mutex::unlock_shared(std::size_t slot) noexcept
+{
+  m_readers[slot].value.fetch_sub(1, std::memory_order_seq_cst);
+  if (!m_writer.load(std::memory_order_seq_cst)) {
+    return;
+  }
+  std::unique_lock lock{ m_lock };
+  if (m_pending && !readers()) {
+    const auto writer = std::exchange(m_pending, nullptr);
+    lock.unlock();
+    writer->resume();
+  }
+}
+
+inline bool async_shared_mutex::suspend(detail::async_waiter& waiter) noexcept
+{
+  std::lock_guard lock{ m_lock };
+  if (m_writer.load(std::memory_order_relaxed)) {
+    push(m_writersHead, m_writersTail, waiter);
+    return true;
+  }
+  m_writer.store(true, std::memory_order_seq_cst);
+  if (!readers()) {
+    return false;
+  }
+  m_pending = &waiter;
+  return true;
+}
+
+inline bool async_shared_mutex::suspend_shared(detail::async_waiter& waiter, std::size_t& slot) noexcept
+{
+  // The writer flag only changes while the lock is held.
+  std::lock_guard lock{ m_lock };
+  if (!m_writer.load(std::memory_order_relaxed)) {
+    m_readers[slot].value.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  slot = admitted;
+  push(m_readersHead, m_readersTail, waiter);
+  return true;
+}
+
+inline void async_shared_mutex::unlock() noexcept
+{
+  std::unique_lock lock{ m_lock };
+  const auto readers = std::exchange(m_readersHead, nullptr);
+  m_readersTail = nullptr;
+  for (auto reader = readers; reader; reader = reader->next) {
+    m_readers[admitted].value.fetch_add(1, std::memory_order_relaxed);
+  }
+  auto writer = m_writersHead;
+  if (writer) {
+    m_writersHead = writer->next;
+    if (!m_writersHead) {
+      m_writersTail = nullptr;
+    }
+    if (readers || this->readers()) {
+      m_pending = std::exchange(writer, nullptr);
+    }
+  } else {
+    m_writer.store(false, std::memory_order_release);
+  }
+  lock.unlock();
+  detail::async_waiter::resume(readers);
+  if (writer) {
+    writer->resume();
+  }
+}
+
 template <typename T>
 using async_result = async<result<T>>;
 
@@ -0,0 +1,121 @@
+#pragma once
+#include <ice/config.hpp>
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace ice {
+
+class cancellation_source;
+class cancellation_token;
+class cancellation_registration;
+
+namespace detail {
+
+class cancellation_state {
+public:
+  std::atomic_size_t references = 1;
+  std::atomic_bool requested = false;
+  std::mutex mutex;
+  cancellation_registration* head = nullptr;
+};
+
+}  // namespace detail
+
+// Token that awaitables observe to stop waiting when cancellation is requested by the source.
+class cancellation_token {
+public:
+  cancellation_token() noexcept = default;
+
+  cancellation_token(cancellation_token&& other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+  cancellation_token(const cancellation_token& other) noexcept;
+  cancellation_token& operator=(cancellation_token&& other) noexcept;
+  cancellation_token& operator=(const cancellation_token& other) noexcept;
+
+  ~cancellation_token();
+
+  bool can_be_cancelled() const noexcept
+  {
+    return state_ != nullptr;
+  }
+
+  bool is_cancellation_requested() const noexcept
+  {
+    return state_ && state_->requested.load(std::memory_order_acquire);
+  }
+
+private:
+  friend class cancellation_source;
+  friend class cancellation_registration;
+
+  explicit cancellation_token(detail::cancellation_state* state) noexcept;
+
+  detail::cancellation_state* state_ = nullptr;
+};
+
+class cancellation_source {
+public:
+  cancellation_source() noexcept;
+
+  cancellation_source(cancellation_source&& other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+  cancellation_source(const cancellation_source& other) noexcept;
+  cancellation_source& operator=(cancellation_source&& other) noexcept;
+  cancellation_source& operator=(const cancellation_source& other) noexcept;
+
+  ~cancellation_source();
+
+  cancellation_token token() const noexcept
+  {
+    return cancellation_token{ state_ };
+  }
+
+  bool is_cancellation_requested() const noexcept
+  {
+    return state_ && state_->requested.load(std::memory_order_acquire);
+  }
+
+  // Calls the callbacks of all registrations on the current thread.
+  void request_cancellation() noexcept;
+
+private:
+  detail::cancellation_state* state_ = nullptr;
+};
+
+// Intrusive cancellation callback embedded in an awaiter.
+// The awaiter attaches the registration while it is suspended and detaches it before it resumes. A callback that
+// does not resume the awaiter must call release() once it stopped accessing the awaiter.
+class cancellation_registration {
+public:
+  using callback_type = void (*)(cancellation_registration& registration) noexcept;
+
+  explicit cancellation_registration(callback_type callback) noexcept : callback_(callback) {}
+
+  cancellation_registration(cancellation_registration&& other) = delete;
+  cancellation_registration(const cancellation_registration& other) = delete;
+  cancellation_registration& operator=(cancellation_registration&& other) = delete;
+  cancellation_registration& operator=(const cancellation_registration& other) = delete;
+
+  ~cancellation_registration() = default;
+
+  // Returns false if cancellation was already requested.
+  bool attach(const cancellation_token& token) noexcept;
+
+  // Makes sure that the callback is not running and will not run.
+  void detach() noexcept;
+
+  void release() noexcept
+  {
+    released_.store(true, std::memory_order_release);
+  }
+
+private:
+  friend class cancellation_source;
+
+  callback_type callback_ = nullptr;
+  detail::cancellation_state* state_ = nullptr;
+  cancellation_registration* next_ = nullptr;
+  cancellation_registration** link_ = nullptr;
+  std::atomic_bool released_ = false;
+};
+
+}  // namespace ice
@@ -0,0 +1,426 @@
+#pragma once
+#include <ice/config.hpp>
+#include <ice/scheduler.hpp>
+#include <ice/utility.hpp>
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace ice {
+namespace detail {
+
+template <typename T>
+class channel_waiter {
+public:
+  using resume_type = void (*)(channel_waiter& waiter) noexcept;
+
+  explicit channel_waiter(resume_type resume) noexcept : resume(resume) {}
+
+  // The value to send or the received value.
+  std::optional<T> value;
+  channel_waiter* next = nullptr;
+  resume_type resume = nullptr;
+  bool result = false;
+};
+
+// Intrusive FIFO list of suspended senders or receivers.
+// A waiter is only added when the retry after announcing it still fails, and the other side checks for announced
+// waiters after every successful operation, so that a waiter can not miss the operation that it waits for.
+template <typename T>
+class channel_waiters {
+public:
+  using waiter_type = channel_waiter<T>;
+
+  channel_waiters() noexcept = default;
+
+  channel_waiters(channel_waiters&& other) = delete;
+  channel_waiters(const channel_waiters& other) = delete;
+  channel_waiters& operator=(channel_waiters&& other) = delete;
+  channel_waiters& operator=(const channel_waiters& other) = delete;
+
+  ~channel_waiters() = default;
+
+  // Adds the waiter unless the retry succeeds. Returns true if the waiter was added.
+  template <typename Retry>
+  bool suspend(waiter_type& waiter, Retry&& retry) noexcept
+  {
+    std::lock_guard lock{ mutex_ };
+    size_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (retry()) {
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      return false;
+    }
+    waiter.next = nullptr;
+    if (tail_) {
+      tail_->next = &waiter;
+    } else {
+      head_ = &waiter;
+    }
+    tail_ = &waiter;
+    return true;
+  }
+
+  // Completes the first waiter with the handoff and resumes it. Returns true if a waiter was resumed.
+  template <typename Handoff>
+  bool notify(Handoff&& handoff) noexcept
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!size_.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    std::unique_lock lock{ mutex_ };
+    const auto waiter = head_;
+    if (!waiter || !handoff(*waiter)) {
+      return false;
+    }
+    head_ = waiter->next;
+    if (!head_) {
+      tail_ = nullptr;
+    }
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    lock.unlock();
+    waiter->resume(*waiter);
+    return true;
+  }
+
+  // Completes and resumes all waiters.
+  template <typename Handoff>
+  void close(Handoff&& handoff) noexcept
+  {
+    std::unique_lock lock{ mutex_ };
+    auto waiter = std::exchange(head_, nullptr);
+    tail_ = nullptr;
+    size_.store(0, std::memory_order_relaxed);
+    lock.unlock();
+    while (waiter) {
+      const auto next = waiter->next;
+      handoff(*waiter);
+      waiter->resume(*waiter);
+      waiter = next;
+    }
+  }
+
+private:
+  std::atomic_size_t size_ = 0;
+  waiter_type* head_ = nullptr;
+  waiter_type* tail_ = nullptr;
+  spin_lock mutex_;
+};
+
+}  // namespace detail
+
+// Bounded multi-producer multi-consumer channel between coroutines.
+// Values are stored in a lock-free ring buffer by Dmitry Vyukov. Senders suspend while the channel is full and
+// receivers suspend while it is empty. A suspended sender or receiver is completed by the coroutine that makes room
+// or sends a value and is resumed on the scheduler that it was suspended on.
+template <typename T, std::size_t N>
+class channel {
+public:
+  static_assert(N > 1 && (N & (N - 1)) == 0, "channel capacity must be a power of two");
+  static_assert(std::is_nothrow_move_constructible_v<T>, "channel values must be nothrow move constructible");
+
+  using waiter_type = detail::channel_waiter<T>;
+
+  template <typename Scheduler>
+  class send_awaitable final : private waiter_type {
+  public:
+    send_awaitable(channel& channel, T value, Scheduler& scheduler) noexcept :
+      waiter_type(post), channel_(channel), schedule_(scheduler, true)
+    {
+      this->value.emplace(std::move(value));
+    }
+
+    send_awaitable(send_awaitable&& other) = delete;
+    send_awaitable(const send_awaitable& other) = delete;
+    send_awaitable& operator=(send_awaitable&& other) = delete;
+    send_awaitable& operator=(const send_awaitable& other) = delete;
+
+    ~send_awaitable() = default;
+
+    bool await_ready() noexcept
+    {
+      return channel_.try_send(*this);
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiter) noexcept
+    {
+      awaiter_ = awaiter;
+      return channel_.suspend_send(*this);
+    }
+
+    // Returns false if the channel was closed.
+    bool await_resume() const noexcept
+    {
+      return this->result;
+    }
+
+  private:
+    static void post(waiter_type& waiter) noexcept
+    {
+      auto& self = static_cast<send_awaitable&>(waiter);
+      self.schedule_.await_suspend(self.awaiter_);
+    }
+
+    channel& channel_;
+    ice::schedule<Scheduler> schedule_;
+    std::coroutine_handle<> awaiter_;
+  };
+
+  template <typename Scheduler>
+  class recv_awaitable final : private waiter_type {
+  public:
+    recv_awaitable(channel& channel, Scheduler& scheduler) noexcept :
+      waiter_type(post), channel_(channel), schedule_(scheduler, true)
+    {}
+
+    recv_awaitable(recv_awaitable&& other) = delete;
+    recv_awaitable(const recv_awaitable& other) = delete;
+    recv_awaitable& operator=(recv_awaitable&& other) = delete;
+    recv_awaitable& operator=(const recv_awaitable& other) = delete;
+
+    ~recv_awaitable() = default;
+
+    bool await_ready() noexcept
+    {
+      return channel_.try_recv(*this);
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiter) noexcept
+    {
+      awaiter_ = awaiter;
+      return channel_.suspend_recv(*this);
+    }
+
+    // Returns std::nullopt if the channel was closed and is empty.
+    std::optional<T> await_resume() noexcept
+    {
+      return std::move(this->value);
+    }
+
+  private:
+    static void post(waiter_type& waiter) noexcept
+    {
+      auto& self = static_cast<recv_awaitable&>(waiter);
+      self.schedule_.await_suspend(self.awaiter_);
+    }
+
+    channel& channel_;
+    ice::schedule<Scheduler> schedule_;
+    std::coroutine_handle<> awaiter_;
+  };
+
+  channel() noexcept
+  {
+    for (std::size_t i = 0; i < N; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  channel(channel&& other) = delete;
+  channel(const channel& other) = delete;
+  channel& operator=(channel&& other) = delete;
+  channel& operator=(const channel& other) = delete;
+
+  ~channel()
+  {
+    std::optional<T> value;
+    while (pop(value)) {
+      value.reset();
+    }
+  }
+
+  // Sends the value and resumes on the given scheduler if the channel is full.
+  template <typename Scheduler>
+  send_awaitable<Scheduler> send(T value, Scheduler& scheduler) noexcept
+  {
+    return { *this, std::move(value), scheduler };
+  }
+
+  // Receives a value and resumes on the given scheduler if the channel is empty.
+  template <typename Scheduler>
+  recv_awaitable<Scheduler> recv(Scheduler& scheduler) noexcept
+  {
+    return { *this, scheduler };
+  }
+
+  // Resumes all suspended senders with false and all suspended receivers with the remaining values or std::nullopt.
+  // Values that are still in the channel can be received after it was closed.
+  void close() noexcept
+  {
+    closed_.store(true, std::memory_order_seq_cst);
+    senders_.close([](waiter_type& waiter) { waiter.result = false; });
+    receivers_.close([this](waiter_type& waiter) { pop(waiter.value); });
+  }
+
+  bool closed() const noexcept
+  {
+    return closed_.load(std::memory_order_acquire);
+  }
+
+private:
+  struct cell {
+    std::atomic_size_t sequence;
+    alignas(T) std::byte storage[sizeof(T)];
+  };
+
+  // Returns true if the operation completed without suspending.
+  bool try_send(waiter_type& waiter) noexcept
+  {
+    if (closed_.load(std::memory_order_acquire)) {
+      waiter.result = false;
+      return true;
+    }
+    if (!push(*waiter.value)) {
+      return false;
+    }
+    waiter.result = true;
+    pushed();
+    return true;
+  }
+
+  bool try_recv(waiter_type& waiter) noexcept
+  {
+    if (pop(waiter.value)) {
+      popped();
+      return true;
+    }
+    if (closed_.load(std::memory_order_acquire)) {
+      if (pop(waiter.value)) {
+        popped();
+      }
+      return true;
+    }
+    return false;
+  }
+
+  // Returns true if the awaiter was suspended.
+  bool suspend_send(waiter_type& waiter) noexcept
+  {
+    if (senders_.suspend(waiter, [&]() { return try_push(waiter); })) {
+      return true;
+    }
+    if (waiter.result) {
+      pushed();
+    }
+    return false;
+  }
+
+  bool suspend_recv(waiter_type& waiter) noexcept
+  {
+    if (receivers_.suspend(waiter, [&]() { return pop(waiter.value) || closed_.load(std::memory_order_acquire); })) {
+      return true;
+    }
+    if (waiter.value) {
+      popped();
+    }
+    return false;
+  }
+
+  bool try_push(waiter_type& waiter) noexcept
+  {
+    if (closed_.load(std::memory_order_acquire)) {
+      waiter.result = false;
+      return true;
+    }
+    waiter.result = push(*waiter.value);
+    return waiter.result;
+  }
+
+  // Hands values to suspended receivers and suspended senders to the freed slots until one of the sides is done.
+  void pushed() noexcept
+  {
+    while (receivers_.notify([this](waiter_type& waiter) { return give(waiter); })) {
+      if (!senders_.notify([this](waiter_type& waiter) { return take(waiter); })) {
+        break;
+      }
+    }
+  }
+
+  void popped() noexcept
+  {
+    while (senders_.notify([this](waiter_type& waiter) { return take(waiter); })) {
+      if (!receivers_.notify([this](waiter_type& waiter) { return give(waiter); })) {
+        break;
+      }
+    }
+  }
+
+  // Moves a value from the ring buffer to a suspended receiver.
+  bool give(waiter_type& waiter) noexcept
+  {
+    return pop(waiter.value);
+  }
+
+  // Moves the value of a suspended sender to the ring buffer.
+  bool take(waiter_type& waiter) noexcept
+  {
+    waiter.result = push(*waiter.value);
+    return waiter.result;
+  }
+
+  // Moves the value into the ring buffer. Returns false and leaves the value unchanged if the channel is full.
+  bool push(T& value) noexcept
+  {
+    auto position = enqueue_.load(std::memory_order_relaxed);
+    cell* entry = nullptr;
+    while (true) {
+      entry = &cells_[position & (N - 1)];
+      const auto sequence = entry->sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+      if (difference == 0) {
+        if (enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = enqueue_.load(std::memory_order_relaxed);
+      }
+    }
+    new (entry->storage) T(std::move(value));
+    entry->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(std::optional<T>& value) noexcept
+  {
+    auto position = dequeue_.load(std::memory_order_relaxed);
+    cell* entry = nullptr;
+    while (true) {
+      entry = &cells_[position & (N - 1)];
+      const auto sequence = entry->sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+      if (difference == 0) {
+        if (dequeue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = dequeue_.load(std::memory_order_relaxed);
+      }
+    }
+    const auto data = std::launder(reinterpret_cast<T*>(entry->storage));
+    value.emplace(std::move(*data));
+    data->~T();
+    entry->sequence.store(position + N, std::memory_order_release);
+    return true;
+  }
+
+  alignas(64) std::atomic_size_t enqueue_ = 0;
+  alignas(64) std::atomic_size_t dequeue_ = 0;
+  alignas(64) std::array<cell, N> cells_;
+  detail::channel_waiters<T> senders_;
+  detail::channel_waiters<T> receivers_;
+  std::atomic_bool closed_ = false;
+};
+
+}  // namespace ice
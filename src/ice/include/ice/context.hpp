@@ -2,32 +2,49 @@
 #include <ice/config.hpp>
 #include <ice/scheduler.hpp>
 #include <ice/utility.hpp>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
+#include <thread>
+#include <utility>
+#include <cstddef>
 
 namespace ice {
 
 class context final : public scheduler<context> {
 public:
+  // Polls the queue the given number of times before the thread goes to sleep when it runs out of work.
+  // Spinning avoids the cost of waking up a sleeping thread when work is posted from another thread at a high rate.
+  // It is disabled on single processor systems, where the thread that posts can not run while this one spins.
+  explicit context(std::size_t spin = 0) noexcept : spin_(std::thread::hardware_concurrency() > 1 ? spin : 0) {}
+
+  context(context&& other) = delete;
+  context(const context& other) = delete;
+  context& operator=(context&& other) = delete;
+  context& operator=(const context& other) = delete;
+
+  ~context() = default;
+
   void run() noexcept
   {
     const auto index = index_.set(this);
-    std::unique_lock lock{ mutex_ };
-    lock.unlock();
     while (true) {
-      lock.lock();
+      expire();
       auto head = acquire();
-      while (!head) {
+      for (std::size_t i = 0; !head && i < spin_; i++) {
+        cpu_relax();
+        if (!empty()) {
+          head = acquire();
+        }
+      }
+      if (!head) {
         if (stop_.load(std::memory_order_acquire)) {
-          lock.unlock();
           return;
         }
-        cv_.wait(lock, [&]() {
-          head = acquire();
-          return head || stop_.load(std::memory_order_acquire);
-        });
+        park();
+        continue;
       }
-      lock.unlock();
       while (head) {
         auto next = head->next.load(std::memory_order_relaxed);
         head->resume();
@@ -43,21 +60,70 @@ public:
 
   void stop(bool stop = true) noexcept
   {
-    stop_.store(stop, std::memory_order_release);
+    {
+      std::lock_guard lock{ mutex_ };
+      stop_.store(stop, std::memory_order_release);
+    }
     cv_.notify_all();
   }
 
+  // Wakes up the context thread only when it is sleeping and no other post has woken it up yet.
   void post(ice::schedule<context>* schedule) noexcept
   {
     scheduler::post(schedule);
-    cv_.notify_one();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) && sleeping_.exchange(false, std::memory_order_relaxed)) {
+      { std::lock_guard lock{ mutex_ }; }
+      cv_.notify_one();
+    }
+  }
+
+  // Inserts the timer and wakes up the context thread so that it can update the wait timeout.
+  void post(ice::timer* timer) noexcept
+  {
+    scheduler::post(timer);
+    if (is_current()) {
+      return;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+      {
+        std::lock_guard lock{ mutex_ };
+        timers_changed_ = true;
+      }
+      cv_.notify_one();
+    }
   }
 
 private:
+  // Posts that happen after the sleeping flag is raised take the lock before they notify and can not slip in
+  // between the check and the wait. The flag is raised again after every wakeup, because a post that found it
+  // raised may have pushed a coroutine that was already resumed.
+  void park() noexcept
+  {
+    std::unique_lock lock{ mutex_ };
+    while (true) {
+      sleeping_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (!empty() || stop_.load(std::memory_order_acquire) || std::exchange(timers_changed_, false)) {
+        break;
+      }
+      if (const auto timeout = scheduler::timeout(); timeout < 0) {
+        cv_.wait(lock);
+      } else if (cv_.wait_for(lock, std::chrono::milliseconds(timeout)) == std::cv_status::timeout) {
+        break;
+      }
+    }
+    sleeping_.store(false, std::memory_order_relaxed);
+  }
+
+  const std::size_t spin_ = 0;
   std::atomic_bool stop_ = false;
+  std::atomic_bool sleeping_ = false;
   thread_local_storage index_;
   std::condition_variable cv_;
   std::mutex mutex_;
+  bool timers_changed_ = false;
 };
 
 }  // namespace ice
@@ -0,0 +1,109 @@
+#pragma once
+#include <ice/config.hpp>
+#include <array>
+#include <concepts>
+#include <new>
+#include <cstddef>
+
+namespace ice {
+
+// Memory for coroutine frames that belong to one connection or request.
+// Freed frames are kept in size classes and reused, larger frames are allocated from the global heap. The memory is
+// released when the arena is destroyed. The arena is not synchronized: frames must be allocated and freed on the thread
+// that currently owns the arena and all frames must be destroyed before the arena.
+class frame_arena {
+public:
+  static constexpr std::size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+  static constexpr std::size_t granularity = 64;
+  static constexpr std::size_t classes = 16;
+
+  explicit frame_arena(std::size_t chunk = 4096) noexcept : chunk_(chunk) {}
+
+  frame_arena(frame_arena&& other) = delete;
+  frame_arena(const frame_arena& other) = delete;
+  frame_arena& operator=(frame_arena&& other) = delete;
+  frame_arena& operator=(const frame_arena& other) = delete;
+
+  ~frame_arena();
+
+  void* allocate(std::size_t size);
+  void deallocate(void* data, std::size_t size) noexcept;
+
+private:
+  struct block {
+    block* next;
+  };
+
+  std::array<block*, classes> blocks_{};
+  block* chunks_ = nullptr;
+  char* data_ = nullptr;
+  std::size_t size_ = 0;
+  std::size_t chunk_ = 0;
+};
+
+// Allocates a coroutine frame from the arena or from the thread local pool when the arena is nullptr.
+void* allocate_frame(std::size_t size, frame_arena* arena);
+
+// Returns a coroutine frame to the arena or pool that it was allocated from.
+void deallocate_frame(void* frame, std::size_t size) noexcept;
+
+template <typename T>
+concept frame_arena_owner = requires(const T& object) {
+  { object.arena() } -> std::convertible_to<frame_arena*>;
+};
+
+// Base class for promise types that allocate coroutine frames from the thread local pool.
+// The frames of member coroutines with up to eight parameters are allocated from the arena of the object when it
+// provides one. The arena operator new is not a template, because coroutines free their frames with the usual operator
+// delete and compilers only pair that with a non-template operator new.
+class frame_allocator {
+public:
+  // Arena of the object that a member coroutine is called on.
+  class arena_ref {
+  public:
+    template <frame_arena_owner T>
+    arena_ref(const T& object) noexcept : arena_(object.arena()) {}
+
+    frame_arena* get() const noexcept
+    {
+      return arena_;
+    }
+
+  private:
+    frame_arena* arena_ = nullptr;
+  };
+
+  // Coroutine parameter that does not affect the allocation.
+  struct argument {
+    argument() noexcept = default;
+
+    template <typename T>
+    argument(const T&) noexcept {}
+  };
+
+  static void* operator new(std::size_t size)
+  {
+    return allocate_frame(size, nullptr);
+  }
+
+  static void* operator new(
+    std::size_t size, arena_ref arena, argument = {}, argument = {}, argument = {}, argument = {}, argument = {},
+    argument = {}, argument = {}, argument = {})
+  {
+    return allocate_frame(size, arena.get());
+  }
+
+  static void operator delete(void* frame, std::size_t size) noexcept
+  {
+    deallocate_frame(frame, size);
+  }
+
+  static void operator delete(
+    void* frame, std::size_t size, arena_ref, argument, argument, argument, argument, argument, argument, argument,
+    argument) noexcept
+  {
+    deallocate_frame(frame, size);
+  }
+};
+
+}  // namespace ice
@@ -0,0 +1,56 @@
+#pragma once
+#include <ice/config.hpp>
+#include <ice/net/service.hpp>
+#include <ice/timer.hpp>
+#include <atomic>
+#include <thread>
+
+namespace ice::net {
+
+// Service timer that races against the completion of a pending operation.
+// The timer is embedded in the operation awaiter, so waiting with a deadline does not allocate. The completion path
+// calls disarm() before it resumes the awaiter, which guarantees that the timer callback is not running and will not
+// run. A callback that does not resume the awaiter calls done() once it stopped accessing the awaiter.
+class deadline : public timer {
+public:
+  deadline(net::service* service, timer::time_point expiry, timer::callback_type callback) noexcept :
+    timer(expiry, callback), service_(service)
+  {}
+
+  deadline(deadline&& other) = delete;
+  deadline(const deadline& other) = delete;
+  deadline& operator=(deadline&& other) = delete;
+  deadline& operator=(const deadline& other) = delete;
+
+  ~deadline() = default;
+
+  void arm() noexcept
+  {
+    if (service_ && expiry() != timer::time_point::max()) {
+      armed_ = true;
+      service_->post(static_cast<timer*>(this));
+    }
+  }
+
+  void disarm() noexcept
+  {
+    if (armed_ && !service_->cancel(this)) {
+      while (!done_.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+    }
+    armed_ = false;
+  }
+
+  void done() noexcept
+  {
+    done_.store(true, std::memory_order_release);
+  }
+
+private:
+  net::service* service_ = nullptr;
+  std::atomic_bool done_ = false;
+  bool armed_ = false;
+};
+
+}  // namespace ice::net
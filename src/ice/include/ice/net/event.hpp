@@ -1,10 +1,18 @@
 #pragma once
+#include <ice/cancellation.hpp>
 #include <ice/config.hpp>
 #include <ice/error.hpp>
+#include <ice/net/deadline.hpp>
 #include <ice/net/service.hpp>
+#include <ice/net/socket.hpp>
+#include <ice/scheduler.hpp>
+#include <ice/timer.hpp>
 #include <atomic>
 #include <coroutine>
 #include <system_error>
+#include <thread>
+#include <utility>
+#include <cstdint>
 
 #if ICE_OS_WIN32
 #  include <windows.h>
@@ -22,9 +30,17 @@ namespace ice::net {
 
 #if ICE_OS_WIN32
 
-class event final : public OVERLAPPED {
+class event final : public OVERLAPPED, private deadline, private cancellation_registration {
 public:
-  event() noexcept : OVERLAPPED({}) {}
+  event() noexcept :
+    OVERLAPPED({}), deadline(nullptr, timer::time_point::max(), expire), cancellation_registration(cancel)
+  {}
+
+  // Cancels the operation when the deadline expires or cancellation is requested.
+  event(net::socket& socket, timer::time_point deadline, cancellation_token token = {}) noexcept :
+    OVERLAPPED({}), net::deadline(&socket.service(), deadline, expire), cancellation_registration(cancel),
+    token_(std::move(token)), handle_(socket.handle().as<HANDLE>())
+  {}
 
   // clang-format off
 #ifdef __INTELLISENSE__
@@ -47,12 +63,20 @@ public:
     return false;
   }
 
-  void await_suspend(std::coroutine_handle<> awaiter) noexcept
+  // Continues without suspending when the operation completed while the wait was set up.
+  bool await_suspend(std::coroutine_handle<> awaiter) noexcept
   {
     awaiter_ = awaiter;
+    arm();
+    if (!attach(token_)) {
+      cancel(*this);
+    }
     if (ready_.exchange(true, std::memory_order_acq_rel)) {
-      awaiter_.resume();
+      disarm();
+      detach();
+      return false;
     }
+    return true;
   }
 
   constexpr void await_resume() const noexcept {}
@@ -60,78 +84,111 @@ public:
   void resume() noexcept
   {
     if (ready_.exchange(true, std::memory_order_acq_rel)) {
+      disarm();
+      detach();
       awaiter_.resume();
     }
   }
 
+  // Returns the reason for a failed operation.
+  template <typename T>
+  std::error_code error(T code) const noexcept
+  {
+    if (expired_) {
+      return make_error_code(std::errc::timed_out);
+    }
+    if (canceled_) {
+      return make_error_code(std::errc::operation_canceled);
+    }
+    return make_error_code(code);
+  }
+
 private:
+  static void expire(timer& timer) noexcept
+  {
+    auto& ev = static_cast<event&>(static_cast<net::deadline&>(timer));
+    ev.expired_ = true;
+    ::CancelIoEx(ev.handle_, &ev);
+    ev.done();
+  }
+
+  static void cancel(cancellation_registration& registration) noexcept
+  {
+    auto& ev = static_cast<event&>(registration);
+    ev.canceled_ = true;
+    ::CancelIoEx(ev.handle_, &ev);
+    ev.release();
+  }
+
   std::atomic_bool ready_{ false };
   std::coroutine_handle<> awaiter_;
+  cancellation_token token_;
+  HANDLE handle_ = INVALID_HANDLE_VALUE;
+  bool expired_ = false;
+  bool canceled_ = false;
 };
 
-#elif ICE_OS_LINUX
+#else
 
-class event {
+// Persistent registration of a descriptor in the service event queue.
+// Created on the first wait and kept for the lifetime of the descriptor. Readiness is edge-triggered and delivered
+// to separate recv and send waiter slots. Each slot is either idle, ready or holds a pointer to the waiting event.
+class registration {
 public:
-  event(service& service, int handle, uint32_t events) noexcept :
-    service_(service.handle()), handle_(handle), events_(events)
-  {}
+  registration(net::service& service, int handle) noexcept : service(service), handle(handle) {}
 
-  event(event&& other) = delete;
-  event(const event& other) = delete;
-  event& operator=(event&& other) = delete;
-  event& operator=(const event& other) = delete;
-
-  ~event() = default;
+  registration(registration&& other) = delete;
+  registration(const registration& other) = delete;
+  registration& operator=(registration&& other) = delete;
+  registration& operator=(const registration& other) = delete;
 
-  constexpr bool await_ready() const noexcept
-  {
-    return false;
-  }
+  ~registration() = default;
 
-  bool await_suspend(std::coroutine_handle<> awaiter) noexcept
+#  if ICE_OS_LINUX
+  void notify(uint32_t events) noexcept
   {
-    awaiter_ = awaiter;
-    struct epoll_event nev;
-    nev.events = events_ | EPOLLONESHOT;
-    nev.data.ptr = this;
-    if (::epoll_ctl(service_, EPOLL_CTL_ADD, handle_, &nev) < 0) {
-      ec_ = make_error_code(errno);
-      return false;
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+      notify(recv);
+    }
+    if (events & (EPOLLOUT | EPOLLHUP | EPOLLERR)) {
+      notify(send);
     }
-    return true;
   }
-
-  std::error_code await_resume() const noexcept
+#  elif ICE_OS_FREEBSD
+  void notify(short filter) noexcept
   {
-    return ec_;
+    notify(filter == EVFILT_READ ? recv : send);
   }
+#  endif
 
-  void resume() noexcept
-  {
-    struct epoll_event nev;
-    nev.events = events_ | EPOLLONESHOT;
-    nev.data.ptr = this;
-    if (::epoll_ctl(service_, EPOLL_CTL_DEL, handle_, &nev) < 0) {
-      ec_ = make_error_code(errno);
-    }
-    awaiter_.resume();
-  }
+  static void notify(std::atomic<std::uintptr_t>& slot) noexcept;
 
-private:
-  std::coroutine_handle<> awaiter_;
-  std::error_code ec_;
-  int service_ = -1;
-  int handle_ = -1;
-  uint32_t events_ = 0;
-};
+  static constexpr std::uintptr_t idle = 0;
+  static constexpr std::uintptr_t ready = 1;
 
-#elif ICE_OS_FREEBSD
+  std::atomic<std::uintptr_t> recv = idle;
+  std::atomic<std::uintptr_t> send = idle;
+  net::service& service;
+  int handle = -1;
+  registration* next = nullptr;
+};
 
-class event {
+class event final : private deadline, private cancellation_registration {
 public:
-  event(service& service, int handle, short filter) noexcept :
-    service_(service.handle()), handle_(handle), filter_(filter)
+#  if ICE_OS_LINUX
+  using events_type = uint32_t;
+#  elif ICE_OS_FREEBSD
+  using events_type = short;
+#  endif
+
+  // Resumes with std::errc::timed_out when the deadline expires first and with std::errc::operation_canceled when
+  // cancellation is requested first. A canceled wait resumes on the service thread.
+  event(
+    net::socket& socket, events_type events, timer::time_point deadline = timer::time_point::max(),
+    cancellation_token token = {}) noexcept :
+    net::deadline(&socket.service(), deadline, expire),
+    cancellation_registration(cancel), socket_(socket), schedule_(socket.service(), true), token_(std::move(token)),
+    events_(events)
   {}
 
   event(event&& other) = delete;
@@ -149,13 +206,41 @@ public:
   bool await_suspend(std::coroutine_handle<> awaiter) noexcept
   {
     awaiter_ = awaiter;
-    struct kevent nev;
-    EV_SET(&nev, static_cast<uintptr_t>(handle_), filter_, EV_ADD | EV_ONESHOT, 0, 0, this);
-    if (::kevent(service_, &nev, 1, nullptr, 0, nullptr) < 0) {
-      ec_ = make_error_code(errno);
+    const auto registration = socket_.registration(ec_);
+    if (!registration) {
       return false;
     }
-    return true;
+    if (token_.is_cancellation_requested()) {
+      ec_ = make_error_code(std::errc::operation_canceled);
+      return false;
+    }
+    slot_ = events_ == ICE_EVENT_RECV ? &registration->recv : &registration->send;
+    suspending_.store(true, std::memory_order_relaxed);
+    auto state = registration::idle;
+    if (!slot_->compare_exchange_strong(
+          state, reinterpret_cast<std::uintptr_t>(this), std::memory_order_release, std::memory_order_acquire)) {
+      if (state != registration::ready) {
+        ec_ = make_error_code(std::errc::operation_in_progress);
+        return false;
+      }
+      slot_->store(registration::idle, std::memory_order_relaxed);
+      return false;
+    }
+
+    // The waiter is published, but whoever takes it back waits until the deadline and the cancellation callback
+    // are set up and this function no longer accesses the event.
+    arm();
+    auto suspend = true;
+    if (!attach(token_)) {
+      state = reinterpret_cast<std::uintptr_t>(this);
+      if (slot_->compare_exchange_strong(state, registration::idle, std::memory_order_acq_rel)) {
+        disarm();
+        ec_ = make_error_code(std::errc::operation_canceled);
+        suspend = false;
+      }
+    }
+    suspending_.store(false, std::memory_order_release);
+    return suspend;
   }
 
   std::error_code await_resume() const noexcept
@@ -165,17 +250,74 @@ public:
 
   void resume() noexcept
   {
+    wait();
+    disarm();
+    detach();
     awaiter_.resume();
   }
 
 private:
+  void wait() const noexcept
+  {
+    while (suspending_.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Takes the waiter slot back, so that a readiness notification can no longer resume the awaiter.
+  static void expire(timer& timer) noexcept
+  {
+    auto& ev = static_cast<event&>(static_cast<net::deadline&>(timer));
+    auto state = reinterpret_cast<std::uintptr_t>(&ev);
+    if (ev.slot_->compare_exchange_strong(state, registration::idle, std::memory_order_acq_rel)) {
+      ev.wait();
+      ev.detach();
+      ev.ec_ = make_error_code(std::errc::timed_out);
+      ev.awaiter_.resume();
+      return;
+    }
+    ev.done();
+  }
+
+  static void cancel(cancellation_registration& registration) noexcept
+  {
+    auto& ev = static_cast<event&>(registration);
+    auto state = reinterpret_cast<std::uintptr_t>(&ev);
+    if (ev.slot_->compare_exchange_strong(state, registration::idle, std::memory_order_acq_rel)) {
+      ev.wait();
+      ev.disarm();
+      ev.ec_ = make_error_code(std::errc::operation_canceled);
+      ev.schedule_.await_suspend(ev.awaiter_);
+      return;
+    }
+    ev.release();
+  }
+
+  net::socket& socket_;
+  ice::schedule<net::service> schedule_;
+  cancellation_token token_;
+  std::atomic<std::uintptr_t>* slot_ = nullptr;
   std::coroutine_handle<> awaiter_;
   std::error_code ec_;
-  int service_ = -1;
-  int handle_ = -1;
-  short filter_ = 0;
+  std::atomic_bool suspending_ = false;
+  events_type events_ = 0;
 };
 
+inline void registration::notify(std::atomic<std::uintptr_t>& slot) noexcept
+{
+  auto state = slot.load(std::memory_order_acquire);
+  while (state != ready) {
+    if (state == idle) {
+      if (slot.compare_exchange_weak(state, ready, std::memory_order_release, std::memory_order_acquire)) {
+        return;
+      }
+    } else if (slot.compare_exchange_weak(state, idle, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      reinterpret_cast<event*>(state)->resume();
+      return;
+    }
+  }
+}
+
 #endif
 
 }  // namespace ice::net
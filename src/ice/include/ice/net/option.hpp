@@ -30,6 +30,9 @@ public:
   class recv_low_watermark;
   class send_low_watermark;
   class reuse_address;
+#if !ICE_OS_WIN32
+  class reuse_port;
+#endif
 
   virtual ~option() = default;
 
@@ -282,4 +285,14 @@ public:
   int name() const noexcept override;
 };
 
+#if !ICE_OS_WIN32
+
+class option::reuse_port : public option_value<bool> {
+public:
+  using option_value::option_value;
+  int name() const noexcept override;
+};
+
+#endif
+
 }  // namespace ice::net
@@ -2,10 +2,20 @@
 #include <ice/config.hpp>
 #include <ice/scheduler.hpp>
 #include <ice/utility.hpp>
+#include <memory>
+#include <mutex>
 #include <system_error>
 
 namespace ice::net {
 
+#if !ICE_OS_WIN32
+class registration;
+#endif
+
+#if ICE_URING
+class uring;
+#endif
+
 class service final : public scheduler<service> {
 public:
 #if ICE_OS_WIN32
@@ -21,7 +31,16 @@ public:
 #endif
   using handle_view = handle_type::view;
 
-  std::error_code create() noexcept;
+  service();
+  ~service();
+
+  // Submits socket operations to an io_uring instance when requested and supported by the kernel.
+  std::error_code create(bool uring = ICE_URING) noexcept;
+
+  // Runs the event loop on the current thread.
+  // Multiple threads can run the same service. They share the event queue and the ready queue and every operation
+  // is resumed exactly once on one of them. Coroutines that access the same socket from different operations must
+  // not rely on being resumed on the same thread.
   std::error_code run(std::size_t event_buffer_size = 128) noexcept;
 
   bool is_current() const noexcept
@@ -35,10 +54,21 @@ public:
     return interrupt();
   }
 
+  // Interrupts the event loop only when a thread is waiting for events and no other post has woken it up yet.
   std::error_code post(ice::schedule<service>* schedule) noexcept
   {
     scheduler::post(schedule);
-    return interrupt();
+    return wake();
+  }
+
+  // Inserts the timer and interrupts the event loop when it is waiting for events on another thread.
+  std::error_code post(ice::timer* timer) noexcept
+  {
+    scheduler::post(timer);
+    if (is_current()) {
+      return {};
+    }
+    return wake();
   }
 
   handle_view handle() const noexcept
@@ -53,15 +83,49 @@ public:
   }
 #endif
 
+#if ICE_URING
+  net::uring* uring() const noexcept
+  {
+    return uring_.get();
+  }
+#endif
+
+#if !ICE_OS_WIN32
+  registration* attach(int handle, std::error_code& ec) noexcept;
+  void detach(registration* registration) noexcept;
+#endif
+
 private:
+  // Claims one of the waiting threads and interrupts the event loop.
+  std::error_code wake() noexcept
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto sleeping = sleeping_.load(std::memory_order_relaxed);
+    while (sleeping) {
+      if (sleeping_.compare_exchange_weak(sleeping, sleeping - 1, std::memory_order_relaxed)) {
+        return interrupt();
+      }
+    }
+    return {};
+  }
+
+  void awake() noexcept;
   std::error_code interrupt() noexcept;
 
   std::atomic_bool stop_ = false;
+  std::atomic_size_t sleeping_ = 0;
   thread_local_storage index_;
   handle_type handle_;
 #if ICE_OS_LINUX
   handle_type events_;
 #endif
+#if ICE_URING
+  std::unique_ptr<net::uring> uring_;
+#endif
+#if !ICE_OS_WIN32
+  registration* registrations_ = nullptr;
+  std::mutex registrations_mutex_;
+#endif
 };
 
 }  // namespace ice::net
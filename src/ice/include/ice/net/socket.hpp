@@ -1,6 +1,7 @@
 #pragma once
 #include <ice/config.hpp>
 #include <ice/error.hpp>
+#include <ice/frame.hpp>
 #include <ice/handle.hpp>
 #include <ice/net/endpoint.hpp>
 #include <ice/net/option.hpp>
@@ -11,6 +12,10 @@
 
 namespace ice::net {
 
+#if !ICE_OS_WIN32
+class registration;
+#endif
+
 enum class shutdown {
   recv,
   send,
@@ -32,6 +37,13 @@ public:
 #endif
   using handle_view = handle_type::view;
 
+#if !ICE_OS_WIN32
+  struct detach_type {
+    void operator()(net::registration* registration) noexcept;
+  };
+  using registration_type = ice::handle<net::registration*, nullptr, detach_type>;
+#endif
+
   explicit socket(service& service) noexcept : service_(service) {}
 
   socket(socket&& other) noexcept = default;
@@ -53,6 +65,9 @@ public:
 
   void close() noexcept
   {
+#if !ICE_OS_WIN32
+    registration_.reset();
+#endif
     handle_.reset();
   }
 
@@ -88,11 +103,32 @@ public:
     return handle_;
   }
 
+  // Returns the arena that the frames of socket operations are allocated from or nullptr for the thread local pool.
+  frame_arena* arena() const noexcept
+  {
+    return arena_;
+  }
+
+  // Sets the arena for the frames of socket operations. The arena must outlive all pending operations.
+  void arena(frame_arena* arena) noexcept
+  {
+    arena_ = arena;
+  }
+
+#if !ICE_OS_WIN32
+  // Returns the persistent service registration and creates it on first use.
+  net::registration* registration(std::error_code& ec) noexcept;
+#endif
+
 protected:
   std::reference_wrapper<net::service> service_;
   handle_type handle_;
+#if !ICE_OS_WIN32
+  registration_type registration_;
+#endif
 
 private:
+  frame_arena* arena_ = nullptr;
   int family_ = 0;
 };
 
@@ -1,25 +1,186 @@
 #pragma once
 #include <ice/async.hpp>
+#include <ice/cancellation.hpp>
 #include <ice/config.hpp>
 #include <ice/net/endpoint.hpp>
 #include <ice/net/service.hpp>
 #include <ice/net/socket.hpp>
+#include <ice/net/types.hpp>
+#include <ice/timer.hpp>
+#include <span>
 #include <system_error>
+#include <vector>
+#include <cstdint>
 
 namespace ice::net::tcp {
 
 class socket : public net::socket {
 public:
+#if ICE_OS_WIN32
+  using file_handle = void*;
+#else
+  using file_handle = int;
+#endif
+
   explicit socket(net::service& service) noexcept : net::socket(service) {}
 
   std::error_code create(int family) noexcept;
   std::error_code create(int family, int protocol) noexcept;
   std::error_code listen(std::size_t backlog = 0) noexcept;
 
-  async<socket> accept(endpoint& endpoint) noexcept;
-  async<std::error_code> connect(const endpoint& endpoint) noexcept;
-  async<std::size_t> recv(char* data, std::size_t size, std::error_code& ec) noexcept;
-  async<std::size_t> send(const char* data, std::size_t size, std::error_code& ec) noexcept;
+  async<socket> accept(endpoint& endpoint) noexcept
+  {
+    return accept(endpoint, timer::time_point::max(), {});
+  }
+
+  async<std::error_code> connect(const endpoint& endpoint) noexcept
+  {
+    return connect(endpoint, timer::time_point::max(), {});
+  }
+
+  async<std::size_t> accept(std::vector<socket>& clients, std::size_t size, std::error_code& ec) noexcept
+  {
+    return accept(clients, size, timer::time_point::max(), {}, ec);
+  }
+
+  async<std::size_t> recv(char* data, std::size_t size, std::error_code& ec) noexcept
+  {
+    return recv(data, size, timer::time_point::max(), {}, ec);
+  }
+
+  async<std::size_t> send(const char* data, std::size_t size, std::error_code& ec) noexcept
+  {
+    return send(data, size, timer::time_point::max(), {}, ec);
+  }
+
+  async<std::size_t> recv(std::span<const buffer> buffers, std::error_code& ec) noexcept
+  {
+    return recv(buffers, timer::time_point::max(), {}, ec);
+  }
+
+  async<std::size_t> send(std::span<const buffer> buffers, std::error_code& ec) noexcept
+  {
+    return send(buffers, timer::time_point::max(), {}, ec);
+  }
+
+  async<std::size_t> send_file(file_handle file, std::uint64_t offset, std::size_t size, std::error_code& ec) noexcept
+  {
+    return send_file(file, offset, size, timer::time_point::max(), {}, ec);
+  }
+
+  async<std::size_t> send_zerocopy(const char* data, std::size_t size, std::error_code& ec) noexcept
+  {
+    return send_zerocopy(data, size, timer::time_point::max(), {}, ec);
+  }
+
+  async<socket> accept(endpoint& endpoint, timer::time_point deadline) noexcept
+  {
+    return accept(endpoint, deadline, {});
+  }
+
+  async<std::error_code> connect(const endpoint& endpoint, timer::time_point deadline) noexcept
+  {
+    return connect(endpoint, deadline, {});
+  }
+
+  async<std::size_t> accept(
+    std::vector<socket>& clients, std::size_t size, timer::time_point deadline, std::error_code& ec) noexcept
+  {
+    return accept(clients, size, deadline, {}, ec);
+  }
+
+  async<std::size_t> recv(char* data, std::size_t size, timer::time_point deadline, std::error_code& ec) noexcept
+  {
+    return recv(data, size, deadline, {}, ec);
+  }
+
+  async<std::size_t> send(const char* data, std::size_t size, timer::time_point deadline, std::error_code& ec) noexcept
+  {
+    return send(data, size, deadline, {}, ec);
+  }
+
+  async<std::size_t> recv(std::span<const buffer> buffers, timer::time_point deadline, std::error_code& ec) noexcept
+  {
+    return recv(buffers, deadline, {}, ec);
+  }
+
+  async<std::size_t> send(std::span<const buffer> buffers, timer::time_point deadline, std::error_code& ec) noexcept
+  {
+    return send(buffers, deadline, {}, ec);
+  }
+
+  async<std::size_t> send_file(
+    file_handle file, std::uint64_t offset, std::size_t size, timer::time_point deadline, std::error_code& ec) noexcept
+  {
+    return send_file(file, offset, size, deadline, {}, ec);
+  }
+
+  async<std::size_t> send_zerocopy(
+    const char* data, std::size_t size, timer::time_point deadline, std::error_code& ec) noexcept
+  {
+    return send_zerocopy(data, size, deadline, {}, ec);
+  }
+
+  // Operations that stop waiting when the deadline expires or cancellation is requested. The connect, recv and send
+  // operations report std::errc::timed_out or std::errc::operation_canceled and accept returns an invalid socket.
+  // The deadline is only armed when the operation has to wait and does not allocate.
+  async<socket> accept(endpoint& endpoint, timer::time_point deadline, cancellation_token token) noexcept;
+  async<std::error_code> connect(
+    const endpoint& endpoint, timer::time_point deadline, cancellation_token token) noexcept;
+
+  // Waits for a pending connection and then accepts pending connections until the backlog is empty or the given
+  // number of clients was accepted. Appends the clients and returns the number of accepted clients. Errors are only
+  // reported when no client was accepted. Accepts one connection at a time on Windows.
+  async<std::size_t> accept(
+    std::vector<socket>& clients, std::size_t size, timer::time_point deadline, cancellation_token token,
+    std::error_code& ec) noexcept;
+
+  async<std::size_t> recv(
+    char* data, std::size_t size, timer::time_point deadline, cancellation_token token, std::error_code& ec) noexcept;
+
+  async<std::size_t> send(
+    const char* data, std::size_t size, timer::time_point deadline, cancellation_token token,
+    std::error_code& ec) noexcept;
+
+  // Scatter/gather operations. The recv operation fills the buffers in order and returns once any data was received.
+  // The send operation continues partial writes until all buffers were sent or an error occurred.
+  // The buffers must stay valid until the operation completes.
+  async<std::size_t> recv(
+    std::span<const buffer> buffers, timer::time_point deadline, cancellation_token token,
+    std::error_code& ec) noexcept;
+
+  async<std::size_t> send(
+    std::span<const buffer> buffers, timer::time_point deadline, cancellation_token token,
+    std::error_code& ec) noexcept;
+
+  // Sends the given range of a file without copying it through user space. Returns the number of bytes sent, which
+  // is less than the requested size when the end of the file was reached or an error occurred.
+  async<std::size_t> send_file(
+    file_handle file, std::uint64_t offset, std::size_t size, timer::time_point deadline, cancellation_token token,
+    std::error_code& ec) noexcept;
+
+  // Sends the data with MSG_ZEROCOPY on Linux and completes once the kernel reported through the socket error queue
+  // that it no longer references the pages, so that the buffer can be reused. The deadline and the cancellation
+  // token only apply while the data is sent. Only one zero-copy send can be pending on a socket at a time. Falls
+  // back to a regular send on other systems or when the socket does not support SO_ZEROCOPY.
+  async<std::size_t> send_zerocopy(
+    const char* data, std::size_t size, timer::time_point deadline, cancellation_token token,
+    std::error_code& ec) noexcept;
+
+private:
+  bool zerocopy_ = false;
 };
 
+#if !ICE_OS_WIN32
+
+// Creates a listening socket on every service and binds them all to the endpoint with SO_REUSEPORT (SO_REUSEPORT_LB
+// on FreeBSD), so that the kernel distributes incoming connections between the services. When the endpoint uses
+// port 0, all sockets are bound to the port that was assigned to the first one. Replaces the contents of the sockets
+// vector.
+std::error_code listen(
+  std::span<net::service* const> services, const endpoint& endpoint, std::vector<socket>& sockets,
+  std::size_t backlog = 0) noexcept;
+
+#endif
+
 }  // namespace ice::net::tcp
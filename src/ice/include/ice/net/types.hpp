@@ -1,5 +1,6 @@
 #pragma once
 #include <ice/config.hpp>
+#include <cstddef>
 
 struct sockaddr;
 struct sockaddr_in;
@@ -13,4 +14,28 @@ using socklen_t = int;
 using socklen_t = unsigned int;
 #endif
 
+// Buffer of a scatter/gather operation.
+// The layout matches WSABUF on Windows and iovec on other systems, so that buffers are passed to the system as is.
+struct buffer {
+  constexpr buffer() noexcept = default;
+
+  constexpr buffer(char* data, std::size_t size) noexcept :
+#if ICE_OS_WIN32
+    size(static_cast<unsigned long>(size)), data(data)
+#else
+    data(data), size(size)
+#endif
+  {}
+
+  constexpr buffer(const char* data, std::size_t size) noexcept : buffer(const_cast<char*>(data), size) {}
+
+#if ICE_OS_WIN32
+  unsigned long size = 0;
+  char* data = nullptr;
+#else
+  char* data = nullptr;
+  std::size_t size = 0;
+#endif
+};
+
 }  // namespace ice::net
@@ -0,0 +1,127 @@
+#pragma once
+#include <ice/async.hpp>
+#include <ice/cancellation.hpp>
+#include <ice/config.hpp>
+#include <ice/net/endpoint.hpp>
+#include <ice/net/service.hpp>
+#include <ice/net/socket.hpp>
+#include <ice/net/types.hpp>
+#include <ice/timer.hpp>
+#include <span>
+#include <system_error>
+#include <cstddef>
+
+namespace ice::net::udp {
+
+// Datagram of a batched operation.
+// Receive operations fill the buffer and set the size to the number of received bytes and the endpoint to the
+// sender. Send operations send the buffer to the endpoint and set the size to the number of sent bytes.
+struct datagram {
+  net::buffer buffer;
+  net::endpoint endpoint;
+  std::size_t size = 0;
+
+  // Size of the segments that a datagram received with generic receive offload consists of or 0.
+  std::size_t segment_size = 0;
+};
+
+class socket : public net::socket {
+public:
+  explicit socket(net::service& service) noexcept : net::socket(service) {}
+
+  std::error_code create(int family) noexcept;
+
+  // Enables generic receive offload on Linux, which lets the kernel coalesce datagrams of the same flow into one
+  // buffer. Batched receive operations report the segment size of coalesced datagrams. Reports
+  // std::errc::operation_not_supported on other systems.
+  std::error_code gro(bool enable = true) noexcept;
+
+  async<std::size_t> recv_from(char* data, std::size_t size, endpoint& endpoint, std::error_code& ec) noexcept
+  {
+    return recv_from(data, size, endpoint, timer::time_point::max(), {}, ec);
+  }
+
+  async<std::size_t> send_to(const char* data, std::size_t size, const endpoint& endpoint, std::error_code& ec) noexcept
+  {
+    return send_to(data, size, endpoint, timer::time_point::max(), {}, ec);
+  }
+
+  async<std::size_t> recv_from(std::span<datagram> datagrams, std::error_code& ec) noexcept
+  {
+    return recv_from(datagrams, timer::time_point::max(), {}, ec);
+  }
+
+  async<std::size_t> send_to(std::span<datagram> datagrams, std::error_code& ec) noexcept
+  {
+    return send_to(datagrams, timer::time_point::max(), {}, ec);
+  }
+
+  async<std::size_t> send_segments(
+    const char* data, std::size_t size, std::size_t segment_size, const endpoint& endpoint,
+    std::error_code& ec) noexcept
+  {
+    return send_segments(data, size, segment_size, endpoint, timer::time_point::max(), {}, ec);
+  }
+
+  async<std::size_t> recv_from(
+    char* data, std::size_t size, endpoint& endpoint, timer::time_point deadline, std::error_code& ec) noexcept
+  {
+    return recv_from(data, size, endpoint, deadline, {}, ec);
+  }
+
+  async<std::size_t> send_to(
+    const char* data, std::size_t size, const endpoint& endpoint, timer::time_point deadline,
+    std::error_code& ec) noexcept
+  {
+    return send_to(data, size, endpoint, deadline, {}, ec);
+  }
+
+  async<std::size_t> recv_from(std::span<datagram> datagrams, timer::time_point deadline, std::error_code& ec) noexcept
+  {
+    return recv_from(datagrams, deadline, {}, ec);
+  }
+
+  async<std::size_t> send_to(std::span<datagram> datagrams, timer::time_point deadline, std::error_code& ec) noexcept
+  {
+    return send_to(datagrams, deadline, {}, ec);
+  }
+
+  async<std::size_t> send_segments(
+    const char* data, std::size_t size, std::size_t segment_size, const endpoint& endpoint,
+    timer::time_point deadline, std::error_code& ec) noexcept
+  {
+    return send_segments(data, size, segment_size, endpoint, deadline, {}, ec);
+  }
+
+  // Operations that stop waiting when the deadline expires or cancellation is requested and report
+  // std::errc::timed_out or std::errc::operation_canceled. The endpoint of recv_from must stay valid until the
+  // operation completes.
+  async<std::size_t> recv_from(
+    char* data, std::size_t size, endpoint& endpoint, timer::time_point deadline, cancellation_token token,
+    std::error_code& ec) noexcept;
+
+  async<std::size_t> send_to(
+    const char* data, std::size_t size, const endpoint& endpoint, timer::time_point deadline,
+    cancellation_token token, std::error_code& ec) noexcept;
+
+  // Batched operations that use recvmmsg and sendmmsg. The recv operation waits until a datagram is available and
+  // then receives datagrams until the span is full or no more datagrams are queued. Returns the number of received
+  // datagrams. The send operation continues until all datagrams were sent or an error occurred and returns the
+  // number of sent datagrams. Windows transfers one datagram per system call.
+  async<std::size_t> recv_from(
+    std::span<datagram> datagrams, timer::time_point deadline, cancellation_token token,
+    std::error_code& ec) noexcept;
+
+  async<std::size_t> send_to(
+    std::span<datagram> datagrams, timer::time_point deadline, cancellation_token token,
+    std::error_code& ec) noexcept;
+
+  // Sends the data as datagrams of the given segment size, where the last datagram can be shorter. Uses generic
+  // segmentation offload on Linux, which passes up to 64 segments to the kernel in one system call, and sends every
+  // segment separately when it is not supported. Returns the number of sent bytes.
+  async<std::size_t> send_segments(
+    const char* data, std::size_t size, std::size_t segment_size, const endpoint& endpoint,
+    timer::time_point deadline, cancellation_token token, std::error_code& ec) noexcept;
+};
+
+}  // namespace ice::net::udp
@@ -1,5 +1,7 @@
 #pragma once
 #include <ice/async.hpp>
+#include <ice/error.hpp>
+#include <ice/stream.hpp>
 #include <functional>
 #include <regex>
 #include <string>
@@ -25,7 +27,7 @@ public:
   using option = std::regex_constants::syntax_option_type;
   using handler = std::function<async_state(const std::smatch& sm, std::error_code& ec)>;
 
-  void add(const std::string& regex, handler handler, option option = static_cast<option>(0))
+  void add(const std::string& regex, handler handler, option option = static_cast<parser::option>(0))
   {
     matchers_.emplace_back(regex, std::move(handler), option);
   }
@@ -121,6 +123,30 @@ public:
     co_return ec;
   }
 
+  // Parses buffered data one character at a time and only receives data when the buffer is empty.
+  // Data after the character that stopped the parser stays in the buffer.
+  template <typename Stream>
+  ice::async<std::error_code> run(buffered_stream<Stream>& stream)
+  {
+    std::error_code ec;
+    while (true) {
+      if (stream.buffered().empty()) {
+        if (const auto data = co_await stream.peek(ec); data.empty()) {
+          if (!ec) {
+            ec = make_error_code(errc::eof);
+          }
+          break;
+        }
+      }
+      const auto c = stream.buffered().front();
+      stream.consume(1);
+      if (co_await parse(c, ec) == state::done || ec) {
+        break;
+      }
+    }
+    co_return ec;
+  }
+
 private:
   class matcher {
   public:
@@ -1,16 +1,28 @@
 #pragma once
+#include <ice/cancellation.hpp>
 #include <ice/config.hpp>
+#include <ice/error.hpp>
+#include <ice/timer.hpp>
 #include <atomic>
+#include <chrono>
 #include <coroutine>
+#include <limits>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
 #include <cassert>
 
 namespace ice {
 
+template <typename I>
+class scheduler;
+
 template <typename Scheduler>
 class schedule {
 public:
   schedule(Scheduler& scheduler, bool post = false) noexcept :
-    scheduler_(scheduler), ready_(!post && scheduler.is_current())
+    scheduler_(&scheduler), ready_(!post && scheduler.is_current())
   {}
 
   // clang-format off
@@ -37,7 +49,7 @@ public:
   void await_suspend(std::coroutine_handle<> awaiter) noexcept
   {
     awaiter_ = awaiter;
-    scheduler_.post(this);
+    scheduler_->post(this);
   }
 
   constexpr void await_resume() const noexcept {}
@@ -50,11 +62,96 @@ public:
   std::atomic<schedule*> next{ nullptr };
 
 private:
-  Scheduler& scheduler_;
+  friend class scheduler<Scheduler>;
+
+  // Creates the stub node of the scheduler queue.
+  schedule() noexcept = default;
+
+  Scheduler* scheduler_ = nullptr;
   const bool ready_ = true;
   std::coroutine_handle<> awaiter_;
 };
 
+template <typename Scheduler>
+class schedule_at final : public timer, private cancellation_registration {
+public:
+  // Resumes with std::errc::operation_canceled on the scheduler thread when cancellation is requested first.
+  schedule_at(Scheduler& scheduler, timer::time_point expiry, cancellation_token token = {}) noexcept :
+    timer(expiry, expire), cancellation_registration(cancel), scheduler_(scheduler), schedule_(scheduler, true),
+    token_(std::move(token))
+  {}
+
+  schedule_at(schedule_at&& other) = delete;
+  schedule_at(const schedule_at& other) = delete;
+  schedule_at& operator=(schedule_at&& other) = delete;
+  schedule_at& operator=(const schedule_at& other) = delete;
+
+  ~schedule_at() = default;
+
+  constexpr bool await_ready() const noexcept
+  {
+    return false;
+  }
+
+  bool await_suspend(std::coroutine_handle<> awaiter) noexcept
+  {
+    awaiter_ = awaiter;
+    if (token_.is_cancellation_requested()) {
+      ec_ = make_error_code(std::errc::operation_canceled);
+      return false;
+    }
+    suspending_.store(true, std::memory_order_relaxed);
+    scheduler_.post(static_cast<timer*>(this));
+    auto suspend = true;
+    if (!attach(token_) && scheduler_.cancel(this)) {
+      ec_ = make_error_code(std::errc::operation_canceled);
+      suspend = false;
+    }
+    suspending_.store(false, std::memory_order_release);
+    return suspend;
+  }
+
+  std::error_code await_resume() const noexcept
+  {
+    return ec_;
+  }
+
+private:
+  void wait() const noexcept
+  {
+    while (suspending_.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+
+  static void expire(timer& timer) noexcept
+  {
+    auto& self = static_cast<schedule_at&>(timer);
+    self.wait();
+    self.detach();
+    self.awaiter_.resume();
+  }
+
+  static void cancel(cancellation_registration& registration) noexcept
+  {
+    auto& self = static_cast<schedule_at&>(registration);
+    if (self.scheduler_.cancel(&self)) {
+      self.wait();
+      self.ec_ = make_error_code(std::errc::operation_canceled);
+      self.schedule_.await_suspend(self.awaiter_);
+      return;
+    }
+    self.release();
+  }
+
+  Scheduler& scheduler_;
+  ice::schedule<Scheduler> schedule_;
+  cancellation_token token_;
+  std::coroutine_handle<> awaiter_;
+  std::error_code ec_;
+  std::atomic_bool suspending_ = false;
+};
+
 template <typename I>
 class scheduler {
 public:
@@ -72,30 +169,112 @@ public:
     return { static_cast<I&>(*this), post };
   }
 
+  // Resumes execution on the scheduler thread at the given time point.
+  ice::schedule_at<I> schedule_at(timer::time_point expiry, cancellation_token token = {}) noexcept
+  {
+    return { static_cast<I&>(*this), expiry, std::move(token) };
+  }
+
+  // Resumes execution on the scheduler thread after the given duration.
+  template <typename Rep, typename Period>
+  ice::schedule_at<I> schedule_after(
+    std::chrono::duration<Rep, Period> duration, cancellation_token token = {}) noexcept
+  {
+    const auto expiry = timer::clock::now() + std::chrono::ceil<timer::duration>(duration);
+    return { static_cast<I&>(*this), expiry, std::move(token) };
+  }
+
+  // Removes a pending timer. Returns false if the timer already expired.
+  bool cancel(ice::timer* timer) noexcept
+  {
+    std::lock_guard lock{ timers_mutex_ };
+    if (!timers_.remove(*timer)) {
+      return false;
+    }
+    timers_size_.store(timers_.size(), std::memory_order_relaxed);
+    return true;
+  }
+
 protected:
+  // The stub can be pushed behind a node that is still queued, so both ends have to point to it.
+  bool empty() const noexcept
+  {
+    return head_.load(std::memory_order_acquire) == &stub_ && tail_.load(std::memory_order_relaxed) == &stub_;
+  }
+
+  // Takes all coroutines from the queue and returns them as a list in the order in which they were posted.
+  // Returns nullptr when another thread is taking coroutines from the queue at the same time.
   ice::schedule<I>* acquire() noexcept
   {
-    auto head = head_.exchange(nullptr, std::memory_order_acquire);
-    if (!head || !head->next.load(std::memory_order_relaxed)) {
-      return head;
+    if (consuming_.exchange(true, std::memory_order_acquire)) {
+      return nullptr;
     }
-    ice::schedule<I>* prev = nullptr;
-    ice::schedule<I>* next = nullptr;
-    while (head) {
-      next = head->next.exchange(prev, std::memory_order_relaxed);
-      prev = head;
-      head = next;
+    ice::schedule<I>* head = nullptr;
+    ice::schedule<I>* last = nullptr;
+    while (const auto schedule = pop()) {
+      if (last) {
+        last->next.store(schedule, std::memory_order_relaxed);
+      } else {
+        head = schedule;
+      }
+      last = schedule;
     }
-    return prev;
+    if (last) {
+      last->next.store(nullptr, std::memory_order_relaxed);
+    }
+    consuming_.store(false, std::memory_order_release);
+    return head;
   }
 
   void post(ice::schedule<I>* schedule) noexcept
   {
     assert(schedule);
-    auto head = head_.load(std::memory_order_acquire);
-    do {
-      schedule->next.store(head, std::memory_order_relaxed);
-    } while (!head_.compare_exchange_weak(head, schedule, std::memory_order_release, std::memory_order_acquire));
+    push(schedule);
+  }
+
+  void post(ice::timer* timer) noexcept
+  {
+    assert(timer);
+    std::lock_guard lock{ timers_mutex_ };
+    timers_.insert(*timer);
+    timers_size_.store(timers_.size(), std::memory_order_relaxed);
+  }
+
+  // Returns the number of milliseconds until the next timer event or -1 if there are no pending timers.
+  int timeout() noexcept
+  {
+    if (!timers_size_.load(std::memory_order_relaxed)) {
+      return -1;
+    }
+    std::unique_lock lock{ timers_mutex_ };
+    const auto deadline = timers_.deadline();
+    lock.unlock();
+    if (deadline == timer::time_point::max()) {
+      return -1;
+    }
+    const auto now = timer::clock::now();
+    if (deadline <= now) {
+      return 0;
+    }
+    const auto ms = std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count();
+    return ms < std::numeric_limits<int>::max() ? static_cast<int>(ms) : std::numeric_limits<int>::max();
+  }
+
+  // Resumes timers that expired.
+  void expire() noexcept
+  {
+    if (!timers_size_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    std::unique_lock lock{ timers_mutex_ };
+    auto head = timers_.advance(timer::clock::now());
+    timers_size_.store(timers_.size(), std::memory_order_relaxed);
+    lock.unlock();
+    while (head) {
+      const auto next = timer_wheel::next(head);
+      head->expire();
+      head = next;
+    }
   }
 
   void process()
@@ -109,7 +288,51 @@ protected:
   }
 
 private:
-  std::atomic<ice::schedule<I>*> head_ = nullptr;
+  // Intrusive multi-producer single-consumer queue by Dmitry Vyukov.
+  // Producers exchange the head and link the previous node, consumers follow the links from the tail. The queue
+  // temporarily appears empty to the consumer when a producer is suspended between the exchange and the link.
+  void push(ice::schedule<I>* schedule) noexcept
+  {
+    schedule->next.store(nullptr, std::memory_order_relaxed);
+    const auto prev = head_.exchange(schedule, std::memory_order_acq_rel);
+    prev->next.store(schedule, std::memory_order_release);
+  }
+
+  ice::schedule<I>* pop() noexcept
+  {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    auto next = tail->next.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (!next) {
+        return nullptr;
+      }
+      tail_.store(next, std::memory_order_relaxed);
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+      tail_.store(next, std::memory_order_relaxed);
+      return tail;
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    push(&stub_);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+      tail_.store(next, std::memory_order_relaxed);
+      return tail;
+    }
+    return nullptr;
+  }
+
+  ice::schedule<I> stub_;
+  alignas(64) std::atomic<ice::schedule<I>*> head_ = &stub_;
+  alignas(64) std::atomic<ice::schedule<I>*> tail_ = &stub_;
+  std::atomic_bool consuming_ = false;
+  std::atomic_size_t timers_size_ = 0;
+  std::mutex timers_mutex_;
+  timer_wheel timers_;
 };
 
 }  // namespace ice
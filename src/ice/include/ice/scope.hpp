@@ -0,0 +1,156 @@
+#pragma once
+#include <ice/async.hpp>
+#include <ice/config.hpp>
+#include <ice/frame.hpp>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+
+#if ICE_EXCEPTIONS
+#  include <exception>
+#endif
+
+namespace ice {
+
+class async_scope;
+
+namespace detail {
+
+// Detached coroutine that awaits spawned work and releases its reference on the scope when it completes.
+// The frame is destroyed before the scope is released, so that join can not complete while frames are alive.
+struct async_scope_task {
+  struct promise_type : frame_allocator {
+    promise_type(async_scope& scope, async<void>&) noexcept : scope(scope) {}
+
+    constexpr async_scope_task get_return_object() const noexcept
+    {
+      return {};
+    }
+
+    constexpr auto initial_suspend() const noexcept
+    {
+      return std::suspend_never{};
+    }
+
+    struct final_awaitable {
+      constexpr bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept;
+
+      constexpr void await_resume() const noexcept {}
+    };
+
+    constexpr auto final_suspend() const noexcept
+    {
+      return final_awaitable{};
+    }
+
+    constexpr void return_void() const noexcept {}
+
+#if ICE_EXCEPTIONS || defined(__clang__)
+    void unhandled_exception() const noexcept
+    {
+#  if ICE_EXCEPTIONS
+      std::terminate();
+#  endif
+    }
+#endif
+
+    async_scope& scope;
+  };
+};
+
+}  // namespace detail
+
+// Owns detached work and completes join once all of it finished.
+// The counter holds one reference for the join, so that it can not drop to zero before join was awaited.
+class async_scope {
+public:
+  async_scope() noexcept = default;
+
+  async_scope(async_scope&& other) = delete;
+  async_scope(const async_scope& other) = delete;
+  async_scope& operator=(async_scope&& other) = delete;
+  async_scope& operator=(const async_scope& other) = delete;
+
+  ~async_scope() = default;
+
+  // Starts the work on the calling thread. Work that throws an exception terminates the application.
+  void spawn(async<void> work) noexcept
+  {
+    count_.fetch_add(1, std::memory_order_relaxed);
+    run(*this, std::move(work));
+  }
+
+  // Completes when all spawned work finished. The scope can be reused once join completed.
+  auto join() noexcept
+  {
+    class awaitable {
+    public:
+      explicit awaitable(async_scope& scope) noexcept : scope_(scope) {}
+
+      bool await_ready() const noexcept
+      {
+        return scope_.count_.load(std::memory_order_acquire) == 1;
+      }
+
+      bool await_suspend(std::coroutine_handle<> awaiter) noexcept
+      {
+        scope_.awaiter_ = awaiter;
+        return scope_.count_.fetch_sub(1, std::memory_order_acq_rel) != 1;
+      }
+
+      void await_resume() const noexcept
+      {
+        scope_.count_.store(1, std::memory_order_relaxed);
+      }
+
+    private:
+      async_scope& scope_;
+    };
+    return awaitable{ *this };
+  }
+
+  // Returns the number of spawned coroutines that did not complete yet.
+  std::size_t size() const noexcept
+  {
+    const auto count = count_.load(std::memory_order_relaxed);
+    return count ? count - 1 : 0;
+  }
+
+private:
+  friend struct detail::async_scope_task;
+
+  static detail::async_scope_task run(async_scope&, async<void> work)
+  {
+    co_await std::move(work);
+  }
+
+  std::coroutine_handle<> complete() noexcept
+  {
+    if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      return awaiter_;
+    }
+    return std::noop_coroutine();
+  }
+
+  std::atomic_size_t count_ = 1;
+  std::coroutine_handle<> awaiter_;
+};
+
+namespace detail {
+
+inline std::coroutine_handle<> async_scope_task::promise_type::final_awaitable::await_suspend(
+  std::coroutine_handle<promise_type> coroutine) noexcept
+{
+  auto& scope = coroutine.promise().scope;
+  coroutine.destroy();
+  return scope.complete();
+}
+
+}  // namespace detail
+
+}  // namespace ice
@@ -0,0 +1,213 @@
+#pragma once
+#include <ice/async.hpp>
+#include <ice/config.hpp>
+#include <ice/error.hpp>
+#include <algorithm>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <cstddef>
+#include <cstring>
+
+namespace ice {
+
+// Stream with a receive buffer that is refilled with as much data as the stream provides and a send buffer that
+// coalesces small writes until it is full or flushed. Works with any stream that provides the recv and send
+// operations of tcp::socket and can be used in place of such a stream.
+//
+// Views returned by peek, buffered and read_until stay valid until the next operation that receives data.
+template <typename Stream>
+class buffered_stream {
+public:
+  explicit buffered_stream(Stream& stream, std::size_t recv_size = 4096, std::size_t send_size = 4096) :
+    stream_(stream), recv_(std::make_unique<char[]>(recv_size)), recv_capacity_(recv_size),
+    send_(std::make_unique<char[]>(send_size)), send_capacity_(send_size)
+  {}
+
+  buffered_stream(buffered_stream&& other) = delete;
+  buffered_stream(const buffered_stream& other) = delete;
+  buffered_stream& operator=(buffered_stream&& other) = delete;
+  buffered_stream& operator=(const buffered_stream& other) = delete;
+
+  ~buffered_stream() = default;
+
+  Stream& stream() const noexcept
+  {
+    return stream_;
+  }
+
+  // Returns the received data that was not consumed yet without receiving more data.
+  std::string_view buffered() const noexcept
+  {
+    return { recv_.get() + recv_begin_, recv_end_ - recv_begin_ };
+  }
+
+  // Discards the given number of bytes from the front of the buffered data.
+  void consume(std::size_t size) noexcept
+  {
+    recv_begin_ += std::min(size, recv_end_ - recv_begin_);
+    if (recv_begin_ == recv_end_) {
+      recv_begin_ = 0;
+      recv_end_ = 0;
+    }
+  }
+
+  // Returns the buffered data and receives more data first when the buffer is empty.
+  // Returns an empty view when the stream was closed or an error occurred.
+  async<std::string_view> peek(std::error_code& ec) noexcept
+  {
+    ec.clear();
+    if (recv_begin_ == recv_end_) {
+      co_await fill(ec);
+    }
+    co_return buffered();
+  }
+
+  // Copies buffered data and receives more data first when the buffer is empty.
+  // Reads that are at least as large as the buffer bypass it when it is empty.
+  async<std::size_t> recv(char* data, std::size_t size, std::error_code& ec) noexcept
+  {
+    ec.clear();
+    if (recv_begin_ == recv_end_) {
+      if (size >= recv_capacity_) {
+        const auto rv = co_await stream_.recv(data, size, ec);
+        co_return rv;
+      }
+      if (!co_await fill(ec)) {
+        co_return 0;
+      }
+    }
+    co_return take(data, size);
+  }
+
+  // Reads the given number of bytes and reports errc::eof when the stream was closed before.
+  async<std::size_t> read_exact(char* data, std::size_t size, std::error_code& ec) noexcept
+  {
+    ec.clear();
+    std::size_t read = take(data, size);
+    while (read < size) {
+      if (size - read >= recv_capacity_) {
+        const auto rv = co_await stream_.recv(data + read, size - read, ec);
+        if (ec || !rv) {
+          break;
+        }
+        read += rv;
+        continue;
+      }
+      if (!co_await fill(ec)) {
+        break;
+      }
+      read += take(data + read, size - read);
+    }
+    if (read < size && !ec) {
+      ec = make_error_code(errc::eof);
+    }
+    co_return read;
+  }
+
+  // Reads up to and including the delimiter and returns a view of the data. Reports errc::eof when the stream was
+  // closed and std::errc::no_buffer_space when the buffer is full before the delimiter was received.
+  async<std::string_view> read_until(char delimiter, std::error_code& ec) noexcept
+  {
+    ec.clear();
+    std::size_t scanned = 0;
+    while (true) {
+      const auto data = recv_.get() + recv_begin_;
+      const auto size = recv_end_ - recv_begin_;
+      if (const auto end = std::memchr(data + scanned, delimiter, size - scanned)) {
+        const auto length = static_cast<std::size_t>(static_cast<const char*>(end) - data) + 1;
+        recv_begin_ += length;
+        co_return std::string_view{ data, length };
+      }
+      scanned = size;
+      if (size == recv_capacity_) {
+        ec = make_error_code(std::errc::no_buffer_space);
+        break;
+      }
+      if (!co_await fill(ec)) {
+        if (!ec) {
+          ec = make_error_code(errc::eof);
+        }
+        break;
+      }
+    }
+    co_return std::string_view{};
+  }
+
+  // Appends the data to the send buffer and sends the buffer when it is full.
+  // Writes that do not fit in the buffer are sent directly after the buffer was sent.
+  async<std::size_t> send(const char* data, std::size_t size, std::error_code& ec) noexcept
+  {
+    ec.clear();
+    if (send_size_ + size > send_capacity_) {
+      if (const auto rc = co_await flush()) {
+        ec = rc;
+        co_return 0;
+      }
+      if (size >= send_capacity_) {
+        const auto rv = co_await stream_.send(data, size, ec);
+        co_return rv;
+      }
+    }
+    std::memcpy(send_.get() + send_size_, data, size);
+    send_size_ += size;
+    co_return size;
+  }
+
+  // Sends the buffered data. Data that could not be sent stays in the buffer.
+  async<std::error_code> flush() noexcept
+  {
+    std::error_code ec;
+    std::size_t sent = 0;
+    while (sent < send_size_) {
+      const auto rv = co_await stream_.send(send_.get() + sent, send_size_ - sent, ec);
+      if (ec) {
+        break;
+      }
+      if (!rv) {
+        ec = make_error_code(errc::eof);
+        break;
+      }
+      sent += rv;
+    }
+    std::memmove(send_.get(), send_.get() + sent, send_size_ - sent);
+    send_size_ -= sent;
+    co_return ec;
+  }
+
+private:
+  // Moves the buffered data to the front of the buffer and receives as much data as fits behind it.
+  async<std::size_t> fill(std::error_code& ec) noexcept
+  {
+    if (recv_begin_) {
+      std::memmove(recv_.get(), recv_.get() + recv_begin_, recv_end_ - recv_begin_);
+      recv_end_ -= recv_begin_;
+      recv_begin_ = 0;
+    }
+    const auto size = co_await stream_.recv(recv_.get() + recv_end_, recv_capacity_ - recv_end_, ec);
+    if (!ec) {
+      recv_end_ += size;
+      co_return size;
+    }
+    co_return 0;
+  }
+
+  std::size_t take(char* data, std::size_t size) noexcept
+  {
+    size = std::min(size, recv_end_ - recv_begin_);
+    std::memcpy(data, recv_.get() + recv_begin_, size);
+    consume(size);
+    return size;
+  }
+
+  Stream& stream_;
+  std::unique_ptr<char[]> recv_;
+  std::size_t recv_capacity_ = 0;
+  std::size_t recv_begin_ = 0;
+  std::size_t recv_end_ = 0;
+  std::unique_ptr<char[]> send_;
+  std::size_t send_capacity_ = 0;
+  std::size_t send_size_ = 0;
+};
+
+}  // namespace ice
@@ -0,0 +1,65 @@
+#pragma once
+#include <ice/async.hpp>
+#include <ice/config.hpp>
+#include <ice/utility.hpp>
+#include <atomic>
+#include <coroutine>
+#include <utility>
+
+namespace ice {
+namespace detail {
+
+// Completion of a task that is awaited by a blocked thread.
+// The waiter does not return before the completing thread stops touching the event, because the event lives on the
+// stack of the waiter. The completing thread marks the event as notified after it called notify_one and the waiter
+// spins for the few instructions between the two stores.
+class sync_wait_event {
+public:
+  sync_wait_event() noexcept = default;
+
+  sync_wait_event(sync_wait_event&& other) = delete;
+  sync_wait_event(const sync_wait_event& other) = delete;
+  sync_wait_event& operator=(sync_wait_event&& other) = delete;
+  sync_wait_event& operator=(const sync_wait_event& other) = delete;
+
+  ~sync_wait_event() = default;
+
+  void wait() noexcept
+  {
+    state_.wait(waiting, std::memory_order_acquire);
+    while (state_.load(std::memory_order_acquire) != notified) {
+      cpu_relax();
+    }
+  }
+
+  static std::coroutine_handle<> set(void* state) noexcept
+  {
+    auto& event = *static_cast<sync_wait_event*>(state);
+    event.state_.store(completed, std::memory_order_release);
+    event.state_.notify_one();
+    event.state_.store(notified, std::memory_order_release);
+    return std::noop_coroutine();
+  }
+
+private:
+  static constexpr int waiting = 0;
+  static constexpr int completed = 1;
+  static constexpr int notified = 2;
+
+  std::atomic_int state_ = waiting;
+};
+
+}  // namespace detail
+
+// Starts the task on the calling thread and blocks until it completes on this or another thread.
+// Returns the result of the task or rethrows its exception.
+template <typename T>
+T sync_wait(async<T> task)
+{
+  detail::sync_wait_event event;
+  task.get_starter().start(detail::continuation{ detail::sync_wait_event::set, &event });
+  event.wait();
+  return std::move(task).operator co_await().await_resume();
+}
+
+}  // namespace ice
@@ -0,0 +1,340 @@
+#pragma once
+#include <ice/config.hpp>
+#include <ice/scheduler.hpp>
+#include <ice/utility.hpp>
+#include <atomic>
+#include <coroutine>
+#include <limits>
+#include <cstddef>
+
+namespace ice {
+namespace detail {
+
+// Intrusive node of a suspended coroutine.
+// The awaiter is resumed on the thread that releases it or posted to the scheduler that it was suspended on.
+// Waits on the primitives in this file can not be canceled. Cancel the operation that releases them instead.
+class async_waiter {
+public:
+  using post_type = void (*)(async_waiter& waiter) noexcept;
+
+  explicit async_waiter(post_type post) noexcept : post_(post) {}
+
+  async_waiter(async_waiter&& other) = delete;
+  async_waiter(const async_waiter& other) = delete;
+  async_waiter& operator=(async_waiter&& other) = delete;
+  async_waiter& operator=(const async_waiter& other) = delete;
+
+  ~async_waiter() = default;
+
+  void resume() noexcept
+  {
+    if (post_) {
+      post_(*this);
+    } else {
+      awaiter.resume();
+    }
+  }
+
+  // Resumes all waiters in the list. The list must not be accessed after the first waiter was resumed.
+  static void resume(async_waiter* waiter) noexcept
+  {
+    while (waiter) {
+      const auto next = waiter->next;
+      waiter->resume();
+      waiter = next;
+    }
+  }
+
+  async_waiter* next = nullptr;
+  std::coroutine_handle<> awaiter;
+
+private:
+  post_type post_ = nullptr;
+};
+
+template <typename Scheduler>
+class async_waiter_base : public async_waiter {
+public:
+  explicit async_waiter_base(Scheduler& scheduler) noexcept : async_waiter(post), schedule_(scheduler, true) {}
+
+private:
+  static void post(async_waiter& waiter) noexcept
+  {
+    auto& self = static_cast<async_waiter_base&>(waiter);
+    self.schedule_.await_suspend(self.awaiter);
+  }
+
+  ice::schedule<Scheduler> schedule_;
+};
+
+template <>
+class async_waiter_base<void> : public async_waiter {
+public:
+  async_waiter_base() noexcept : async_waiter(nullptr) {}
+};
+
+// Awaitable that completes when the primitive is ready or suspends until the primitive releases the waiter.
+template <typename Primitive, typename Scheduler>
+class async_wait final : public async_waiter_base<Scheduler> {
+public:
+  template <typename... Args>
+  explicit async_wait(Primitive& primitive, Args&... scheduler) noexcept :
+    async_waiter_base<Scheduler>(scheduler...), primitive_(primitive)
+  {}
+
+  bool await_ready() noexcept
+  {
+    return primitive_.ready();
+  }
+
+  bool await_suspend(std::coroutine_handle<> awaiter) noexcept
+  {
+    this->awaiter = awaiter;
+    return primitive_.suspend(*this);
+  }
+
+  constexpr void await_resume() const noexcept {}
+
+private:
+  Primitive& primitive_;
+};
+
+}  // namespace detail
+
+// Counting semaphore.
+// Permits are taken with a compare and exchange. Waiters are queued in FIFO order under a spin lock that is only
+// taken when a permit is not available or when a release finds announced waiters.
+class async_semaphore {
+public:
+  explicit async_semaphore(
+    std::size_t count = 0, std::size_t max = std::numeric_limits<std::size_t>::max()) noexcept :
+    count_(count < max ? count : max),
+    max_(max)
+  {}
+
+  async_semaphore(async_semaphore&& other) = delete;
+  async_semaphore(const async_semaphore& other) = delete;
+  async_semaphore& operator=(async_semaphore&& other) = delete;
+  async_semaphore& operator=(const async_semaphore& other) = delete;
+
+  ~async_semaphore() = default;
+
+  // Takes a permit and resumes on the thread that released it if none is available.
+  detail::async_wait<async_semaphore, void> acquire() noexcept
+  {
+    return detail::async_wait<async_semaphore, void>{ *this };
+  }
+
+  // Takes a permit and resumes on the given scheduler if none is available.
+  template <typename Scheduler>
+  detail::async_wait<async_semaphore, Scheduler> acquire(Scheduler& scheduler) noexcept
+  {
+    return detail::async_wait<async_semaphore, Scheduler>{ *this, scheduler };
+  }
+
+  bool try_acquire() noexcept;
+
+  // Adds permits up to the maximum and resumes up to that many waiters after the lock was released.
+  void release(std::size_t count = 1) noexcept;
+
+  std::size_t available() const noexcept
+  {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+private:
+  template <typename Primitive, typename Scheduler>
+  friend class detail::async_wait;
+
+  bool ready() noexcept
+  {
+    return try_acquire();
+  }
+
+  bool suspend(detail::async_waiter& waiter) noexcept;
+
+  std::atomic_size_t count_;
+  std::atomic_size_t waiting_ = 0;
+  const std::size_t max_;
+  detail::async_waiter* head_ = nullptr;
+  detail::async_waiter* tail_ = nullptr;
+  spin_lock mutex_;
+};
+
+// Event that resumes all waiters when it is set and stays set until it is reset.
+// The state is either set, not set or the head of a lock-free list of waiters.
+class async_manual_reset_event {
+public:
+  explicit async_manual_reset_event(bool set = false) noexcept : state_(set ? this : nullptr) {}
+
+  async_manual_reset_event(async_manual_reset_event&& other) = delete;
+  async_manual_reset_event(const async_manual_reset_event& other) = delete;
+  async_manual_reset_event& operator=(async_manual_reset_event&& other) = delete;
+  async_manual_reset_event& operator=(const async_manual_reset_event& other) = delete;
+
+  ~async_manual_reset_event() = default;
+
+  detail::async_wait<async_manual_reset_event, void> wait() noexcept
+  {
+    return detail::async_wait<async_manual_reset_event, void>{ *this };
+  }
+
+  template <typename Scheduler>
+  detail::async_wait<async_manual_reset_event, Scheduler> wait(Scheduler& scheduler) noexcept
+  {
+    return detail::async_wait<async_manual_reset_event, Scheduler>{ *this, scheduler };
+  }
+
+  bool is_set() const noexcept
+  {
+    return state_.load(std::memory_order_acquire) == this;
+  }
+
+  // Sets the event and resumes all waiters.
+  void set() noexcept;
+
+  // Resets the event if it is set.
+  void reset() noexcept
+  {
+    void* state = this;
+    state_.compare_exchange_strong(state, nullptr, std::memory_order_relaxed);
+  }
+
+private:
+  template <typename Primitive, typename Scheduler>
+  friend class detail::async_wait;
+
+  bool ready() const noexcept
+  {
+    return is_set();
+  }
+
+  bool suspend(detail::async_waiter& waiter) noexcept;
+
+  std::atomic<void*> state_;
+};
+
+// Event that resumes one waiter when it is set or stays set until the next wait when there are no waiters.
+class async_auto_reset_event {
+public:
+  explicit async_auto_reset_event(bool set = false) noexcept : semaphore_(set ? 1 : 0, 1) {}
+
+  async_auto_reset_event(async_auto_reset_event&& other) = delete;
+  async_auto_reset_event(const async_auto_reset_event& other) = delete;
+  async_auto_reset_event& operator=(async_auto_reset_event&& other) = delete;
+  async_auto_reset_event& operator=(const async_auto_reset_event& other) = delete;
+
+  ~async_auto_reset_event() = default;
+
+  detail::async_wait<async_semaphore, void> wait() noexcept
+  {
+    return semaphore_.acquire();
+  }
+
+  template <typename Scheduler>
+  detail::async_wait<async_semaphore, Scheduler> wait(Scheduler& scheduler) noexcept
+  {
+    return semaphore_.acquire(scheduler);
+  }
+
+  bool is_set() const noexcept
+  {
+    return semaphore_.available() != 0;
+  }
+
+  void set() noexcept
+  {
+    semaphore_.release();
+  }
+
+  void reset() noexcept
+  {
+    semaphore_.try_acquire();
+  }
+
+private:
+  async_semaphore semaphore_;
+};
+
+// Latch that resumes all waiters when it was counted down to zero.
+class async_latch {
+public:
+  explicit async_latch(std::size_t count) noexcept : count_(count), event_(count == 0) {}
+
+  async_latch(async_latch&& other) = delete;
+  async_latch(const async_latch& other) = delete;
+  async_latch& operator=(async_latch&& other) = delete;
+  async_latch& operator=(const async_latch& other) = delete;
+
+  ~async_latch() = default;
+
+  detail::async_wait<async_manual_reset_event, void> wait() noexcept
+  {
+    return event_.wait();
+  }
+
+  template <typename Scheduler>
+  detail::async_wait<async_manual_reset_event, Scheduler> wait(Scheduler& scheduler) noexcept
+  {
+    return event_.wait(scheduler);
+  }
+
+  bool is_ready() const noexcept
+  {
+    return event_.is_set();
+  }
+
+  void count_down(std::size_t count = 1) noexcept
+  {
+    const auto value = count_.fetch_sub(count, std::memory_order_acq_rel);
+    if (value > 0 && value <= count) {
+      event_.set();
+    }
+  }
+
+private:
+  std::atomic_size_t count_;
+  async_manual_reset_event event_;
+};
+
+// Barrier for a fixed number of participants that can be reused once all participants arrived.
+// The last participant resumes the others and continues without suspending.
+class async_barrier {
+public:
+  explicit async_barrier(std::size_t count) noexcept : count_(count), remaining_(count) {}
+
+  async_barrier(async_barrier&& other) = delete;
+  async_barrier(const async_barrier& other) = delete;
+  async_barrier& operator=(async_barrier&& other) = delete;
+  async_barrier& operator=(const async_barrier& other) = delete;
+
+  ~async_barrier() = default;
+
+  detail::async_wait<async_barrier, void> arrive_and_wait() noexcept
+  {
+    return detail::async_wait<async_barrier, void>{ *this };
+  }
+
+  template <typename Scheduler>
+  detail::async_wait<async_barrier, Scheduler> arrive_and_wait(Scheduler& scheduler) noexcept
+  {
+    return detail::async_wait<async_barrier, Scheduler>{ *this, scheduler };
+  }
+
+private:
+  template <typename Primitive, typename Scheduler>
+  friend class detail::async_wait;
+
+  constexpr bool ready() const noexcept
+  {
+    return false;
+  }
+
+  bool suspend(detail::async_waiter& waiter) noexcept;
+
+  const std::size_t count_;
+  std::atomic_size_t remaining_;
+  std::atomic<detail::async_waiter*> head_ = nullptr;
+};
+
+}  // namespace ice
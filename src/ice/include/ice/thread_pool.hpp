@@ -0,0 +1,95 @@
+#pragma once
+#include <ice/config.hpp>
+#include <ice/scheduler.hpp>
+#include <ice/utility.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <cstddef>
+
+namespace ice {
+
+// Work stealing scheduler that runs coroutines on a fixed number of worker threads.
+// Every worker owns a bounded queue. Coroutines that are scheduled on a worker thread are pushed to its queue and
+// coroutines that are scheduled on other threads are pushed to the shared scheduler queue. Idle workers take work
+// from their own queue first, then from the shared queue and then steal from the other workers.
+class thread_pool final : public scheduler<thread_pool> {
+public:
+  thread_pool() noexcept = default;
+
+  thread_pool(thread_pool&& other) = delete;
+  thread_pool(const thread_pool& other) = delete;
+  thread_pool& operator=(thread_pool&& other) = delete;
+  thread_pool& operator=(const thread_pool& other) = delete;
+
+  ~thread_pool();
+
+  // Starts the given number of workers or one worker per hardware thread.
+  std::error_code create(std::size_t size = 0) noexcept;
+
+  // Waits until the workers stopped.
+  void join() noexcept;
+
+  std::size_t size() const noexcept
+  {
+    return size_;
+  }
+
+  bool is_current() const noexcept
+  {
+    return index_.get() ? true : false;
+  }
+
+  // Stops the workers once all scheduled coroutines are resumed.
+  void stop(bool stop = true) noexcept;
+
+  void post(ice::schedule<thread_pool>* schedule) noexcept;
+
+  // Inserts the timer and wakes up a sleeping worker so that it can update the wait timeout.
+  void post(ice::timer* timer) noexcept;
+
+private:
+  // Bounded queue that is filled by one worker and emptied by all workers in FIFO order.
+  class queue {
+  public:
+    static constexpr std::size_t capacity = 256;
+
+    bool push(ice::schedule<thread_pool>* schedule) noexcept;
+    ice::schedule<thread_pool>* pop() noexcept;
+
+    bool empty() const noexcept
+    {
+      return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+  private:
+    alignas(64) std::atomic_size_t head_ = 0;
+    alignas(64) std::atomic_size_t tail_ = 0;
+    std::array<std::atomic<ice::schedule<thread_pool>*>, capacity> entries_{};
+  };
+
+  struct worker {
+    queue local;
+    std::thread thread;
+  };
+
+  void run(std::size_t index) noexcept;
+  ice::schedule<thread_pool>* acquire(std::size_t index) noexcept;
+  bool ready() const noexcept;
+  void notify() noexcept;
+
+  std::unique_ptr<worker[]> workers_;
+  std::size_t size_ = 0;
+  std::atomic_bool stop_ = false;
+  std::atomic_size_t sleeping_ = 0;
+  thread_local_storage index_;
+  std::condition_variable cv_;
+  std::mutex mutex_;
+  bool timers_changed_ = false;
+};
+
+}  // namespace ice
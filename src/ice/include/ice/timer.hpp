@@ -0,0 +1,107 @@
+#pragma once
+#include <ice/config.hpp>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace ice {
+
+// Intrusive timer node. The callback is called on the scheduler thread when the timer expires.
+class timer {
+public:
+  using clock = std::chrono::steady_clock;
+  using duration = clock::duration;
+  using time_point = clock::time_point;
+  using callback_type = void (*)(timer& timer) noexcept;
+
+  timer(time_point expiry, callback_type callback) noexcept : expiry_(expiry), callback_(callback) {}
+
+  timer(timer&& other) = delete;
+  timer(const timer& other) = delete;
+  timer& operator=(timer&& other) = delete;
+  timer& operator=(const timer& other) = delete;
+
+  ~timer() = default;
+
+  time_point expiry() const noexcept
+  {
+    return expiry_;
+  }
+
+  void expiry(time_point expiry) noexcept
+  {
+    expiry_ = expiry;
+  }
+
+  void expire() noexcept
+  {
+    callback_(*this);
+  }
+
+private:
+  friend class timer_wheel;
+
+  time_point expiry_;
+  callback_type callback_ = nullptr;
+  timer* next_ = nullptr;
+  timer** link_ = nullptr;
+  std::uint64_t tick_ = 0;
+  std::uint16_t slot_ = 0;
+};
+
+// Hierarchical timing wheel with millisecond resolution.
+// Each level has 64 slots and a bitmap of occupied slots. A timer is stored on the level of the highest bit in which
+// its expiry tick differs from the current tick and is cascaded to lower levels as time advances. Insert and remove
+// are constant time, finding the next event only scans one bitmap per level.
+class timer_wheel {
+public:
+  static constexpr std::size_t bits = 6;
+  static constexpr std::size_t slots = std::size_t(1) << bits;
+  static constexpr std::size_t levels = (64 + bits - 1) / bits;
+
+  timer_wheel() noexcept;
+
+  timer_wheel(timer_wheel&& other) = delete;
+  timer_wheel(const timer_wheel& other) = delete;
+  timer_wheel& operator=(timer_wheel&& other) = delete;
+  timer_wheel& operator=(const timer_wheel& other) = delete;
+
+  ~timer_wheel() = default;
+
+  void insert(timer& timer) noexcept;
+
+  // Returns false if the timer is not pending.
+  bool remove(timer& timer) noexcept;
+
+  // Advances the wheel and returns a list of expired timers linked through the timer node.
+  // The returned timers are no longer pending and must be expired by the caller.
+  timer* advance(timer::time_point now) noexcept;
+
+  // Returns the time point of the next expiry or cascade or time_point::max() when the wheel is empty.
+  timer::time_point deadline() const noexcept;
+
+  std::size_t size() const noexcept
+  {
+    return size_;
+  }
+
+  static timer* next(timer* timer) noexcept
+  {
+    return timer->next_;
+  }
+
+private:
+  static constexpr std::uint16_t expired = static_cast<std::uint16_t>(levels * slots);
+
+  std::uint16_t slot(std::uint64_t tick) const noexcept;
+  void link(timer& timer, std::uint16_t slot) noexcept;
+  bool find(std::size_t& level, std::size_t& index, std::uint64_t& tick) const noexcept;
+
+  std::uint64_t tick_ = 0;
+  std::size_t size_ = 0;
+  std::array<std::uint64_t, levels> bitmaps_ = {};
+  std::array<timer*, levels * slots + 1> heads_ = {};
+};
+
+}  // namespace ice
@@ -2,13 +2,22 @@
 #include <ice/config.hpp>
 #include <ice/handle.hpp>
 #include <array>
+#include <atomic>
 #include <string>
 #include <system_error>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <cstdarg>
+#include <cstddef>
 #include <cstdint>
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#elif defined(_M_ARM64) || defined(_M_ARM)
+#  include <intrin.h>
+#endif
+
 #ifndef ICE_LIKELY
 #  ifdef __has_builtin
 #    if __has_builtin(__builtin_expect)
@@ -49,6 +58,57 @@
 
 namespace ice {
 
+// Tells the processor that the current thread is waiting in a spin loop.
+inline void cpu_relax() noexcept
+{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#elif defined(_M_ARM64) || defined(_M_ARM)
+  __yield();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+// Lock for short critical sections that spins and yields to other threads when the owner does not release it soon.
+class spin_lock {
+public:
+  spin_lock() noexcept = default;
+
+  spin_lock(spin_lock&& other) = delete;
+  spin_lock(const spin_lock& other) = delete;
+  spin_lock& operator=(spin_lock&& other) = delete;
+  spin_lock& operator=(const spin_lock& other) = delete;
+
+  ~spin_lock() = default;
+
+  void lock() noexcept
+  {
+    while (locked_.exchange(true, std::memory_order_acquire)) {
+      for (std::size_t i = 0; locked_.load(std::memory_order_relaxed); i++) {
+        if (i < 64) {
+          cpu_relax();
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    }
+  }
+
+  bool try_lock() noexcept
+  {
+    return !locked_.load(std::memory_order_relaxed) && !locked_.exchange(true, std::memory_order_acquire);
+  }
+
+  void unlock() noexcept
+  {
+    locked_.store(false, std::memory_order_release);
+  }
+
+private:
+  std::atomic_bool locked_ = false;
+};
+
 template <typename T, bool = std::is_move_constructible_v<T>>
 struct delete_move_constructor {
   delete_move_constructor() = default;
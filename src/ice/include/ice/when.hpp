@@ -0,0 +1,311 @@
+#pragma once
+#include <ice/async.hpp>
+#include <ice/cancellation.hpp>
+#include <ice/config.hpp>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <coroutine>
+#include <functional>
+#include <limits>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+namespace ice {
+
+// Result of a void task in the tuple returned by when_all.
+struct void_value {};
+
+template <typename T>
+struct when_any_result {
+  std::size_t index = 0;
+  T value;
+};
+
+template <>
+struct when_any_result<void> {
+  std::size_t index = 0;
+};
+
+namespace detail {
+
+template <typename T>
+using when_all_value = std::conditional_t<std::is_void_v<T>, void_value, T>;
+
+template <typename T>
+using when_all_range_value = std::conditional_t<
+  std::is_reference_v<T>, std::reference_wrapper<std::remove_reference_t<T>>, when_all_value<T>>;
+
+// Counts the tasks that did not complete yet and resumes the awaiter from the last one.
+// The awaiter holds one additional reference while it starts the tasks, so that tasks that complete synchronously
+// can not resume it before it suspended.
+class when_all_counter {
+public:
+  explicit when_all_counter(std::size_t count) noexcept : count_(count + 1) {}
+
+  when_all_counter(when_all_counter&& other) = delete;
+  when_all_counter(const when_all_counter& other) = delete;
+  when_all_counter& operator=(when_all_counter&& other) = delete;
+  when_all_counter& operator=(const when_all_counter& other) = delete;
+
+  ~when_all_counter() = default;
+
+  void start(std::coroutine_handle<> awaiter) noexcept
+  {
+    awaiter_ = awaiter;
+  }
+
+  // Releases the reference of the awaiter. Returns false if all tasks already completed.
+  bool suspend() noexcept
+  {
+    return count_.fetch_sub(1, std::memory_order_acq_rel) != 1;
+  }
+
+  std::coroutine_handle<> complete() noexcept
+  {
+    if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      return awaiter_;
+    }
+    return std::noop_coroutine();
+  }
+
+  static std::coroutine_handle<> complete(void* state) noexcept
+  {
+    return static_cast<when_all_counter*>(state)->complete();
+  }
+
+private:
+  std::atomic_size_t count_;
+  std::coroutine_handle<> awaiter_;
+};
+
+template <typename T>
+when_all_value<T> when_all_result(async<T>& task)
+{
+  if constexpr (std::is_void_v<T>) {
+    std::move(task).operator co_await().await_resume();
+    return {};
+  } else {
+    return std::move(task).operator co_await().await_resume();
+  }
+}
+
+template <typename... T>
+class when_all_awaitable {
+public:
+  explicit when_all_awaitable(async<T>... tasks) noexcept : tasks_(std::move(tasks)...), counter_(sizeof...(T)) {}
+
+  when_all_awaitable(when_all_awaitable&& other) = delete;
+  when_all_awaitable(const when_all_awaitable& other) = delete;
+  when_all_awaitable& operator=(when_all_awaitable&& other) = delete;
+  when_all_awaitable& operator=(const when_all_awaitable& other) = delete;
+
+  ~when_all_awaitable() = default;
+
+  constexpr bool await_ready() const noexcept
+  {
+    return sizeof...(T) == 0;
+  }
+
+  bool await_suspend(std::coroutine_handle<> awaiter) noexcept
+  {
+    counter_.start(awaiter);
+    std::apply(
+      [this](auto&... tasks) {
+        (tasks.get_starter().start(continuation{ &when_all_counter::complete, &counter_ }), ...);
+      },
+      tasks_);
+    return counter_.suspend();
+  }
+
+  std::tuple<when_all_value<T>...> await_resume()
+  {
+    return std::apply(
+      [](auto&... tasks) { return std::tuple<when_all_value<T>...>{ when_all_result(tasks)... }; }, tasks_);
+  }
+
+private:
+  std::tuple<async<T>...> tasks_;
+  when_all_counter counter_;
+};
+
+template <typename T>
+class when_all_range_awaitable {
+public:
+  explicit when_all_range_awaitable(std::vector<async<T>> tasks) noexcept :
+    tasks_(std::move(tasks)), counter_(tasks_.size())
+  {}
+
+  when_all_range_awaitable(when_all_range_awaitable&& other) = delete;
+  when_all_range_awaitable(const when_all_range_awaitable& other) = delete;
+  when_all_range_awaitable& operator=(when_all_range_awaitable&& other) = delete;
+  when_all_range_awaitable& operator=(const when_all_range_awaitable& other) = delete;
+
+  ~when_all_range_awaitable() = default;
+
+  bool await_ready() const noexcept
+  {
+    return tasks_.empty();
+  }
+
+  bool await_suspend(std::coroutine_handle<> awaiter) noexcept
+  {
+    counter_.start(awaiter);
+    for (auto& task : tasks_) {
+      task.get_starter().start(continuation{ &when_all_counter::complete, &counter_ });
+    }
+    return counter_.suspend();
+  }
+
+  auto await_resume()
+  {
+    if constexpr (std::is_void_v<T>) {
+      for (auto& task : tasks_) {
+        when_all_result(task);
+      }
+    } else {
+      std::vector<when_all_range_value<T>> values;
+      values.reserve(tasks_.size());
+      for (auto& task : tasks_) {
+        values.emplace_back(when_all_result(task));
+      }
+      return values;
+    }
+  }
+
+private:
+  std::vector<async<T>> tasks_;
+  when_all_counter counter_;
+};
+
+// Records the index of the first task that completes and optionally requests cancellation of the other tasks.
+template <typename T, std::size_t N>
+class when_any_awaitable {
+public:
+  struct entry {
+    when_any_awaitable* awaitable = nullptr;
+    std::size_t index = 0;
+  };
+
+  using tasks_type = std::conditional_t<N == std::dynamic_extent, std::vector<async<T>>, std::array<async<T>, N>>;
+  using entries_type = std::conditional_t<N == std::dynamic_extent, std::vector<entry>, std::array<entry, N>>;
+
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  when_any_awaitable(tasks_type tasks, cancellation_source* source) noexcept :
+    tasks_(std::move(tasks)), counter_(tasks_.size()), source_(source)
+  {
+    assert(!tasks_.empty());
+    if constexpr (N == std::dynamic_extent) {
+      entries_.resize(tasks_.size());
+    }
+    for (std::size_t i = 0; i < entries_.size(); i++) {
+      entries_[i] = { this, i };
+    }
+  }
+
+  when_any_awaitable(when_any_awaitable&& other) = delete;
+  when_any_awaitable(const when_any_awaitable& other) = delete;
+  when_any_awaitable& operator=(when_any_awaitable&& other) = delete;
+  when_any_awaitable& operator=(const when_any_awaitable& other) = delete;
+
+  ~when_any_awaitable() = default;
+
+  constexpr bool await_ready() const noexcept
+  {
+    return false;
+  }
+
+  bool await_suspend(std::coroutine_handle<> awaiter) noexcept
+  {
+    counter_.start(awaiter);
+    for (std::size_t i = 0; i < tasks_.size(); i++) {
+      tasks_[i].get_starter().start(continuation{ &complete, &entries_[i] });
+    }
+    return counter_.suspend();
+  }
+
+  when_any_result<T> await_resume()
+  {
+    const auto index = first_.load(std::memory_order_relaxed);
+    if constexpr (std::is_void_v<T>) {
+      when_all_result(tasks_[index]);
+      return { index };
+    } else {
+      return { index, std::move(tasks_[index]).operator co_await().await_resume() };
+    }
+  }
+
+private:
+  static std::coroutine_handle<> complete(void* state) noexcept
+  {
+    const auto& entry = *static_cast<const when_any_awaitable::entry*>(state);
+    auto& self = *entry.awaitable;
+    auto first = npos;
+    if (self.first_.compare_exchange_strong(first, entry.index, std::memory_order_relaxed) && self.source_) {
+      self.source_->request_cancellation();
+    }
+    return self.counter_.complete();
+  }
+
+  tasks_type tasks_;
+  entries_type entries_{};
+  when_all_counter counter_;
+  cancellation_source* source_ = nullptr;
+  std::atomic_size_t first_ = npos;
+};
+
+}  // namespace detail
+
+// Starts all tasks and resumes with a tuple of their results once the last task completed.
+// The tasks run concurrently when they suspend, the awaiter is resumed on the thread that completes the last task.
+template <typename... T>
+[[nodiscard]] detail::when_all_awaitable<T...> when_all(async<T>... tasks) noexcept
+{
+  return detail::when_all_awaitable<T...>{ std::move(tasks)... };
+}
+
+// Starts all tasks and resumes with a vector of their results in the same order or with void for void tasks.
+template <typename T>
+[[nodiscard]] detail::when_all_range_awaitable<T> when_all(std::vector<async<T>> tasks) noexcept
+{
+  return detail::when_all_range_awaitable<T>{ std::move(tasks) };
+}
+
+// Starts all tasks and resumes with the index and result of the first task that completed.
+// The awaiter is resumed once all tasks completed, because their frames are owned by the awaitable. Tasks that
+// observe a token of the given source stop early, because cancellation is requested when the first task completes.
+template <typename T, std::same_as<async<T>>... Tasks>
+[[nodiscard]] detail::when_any_awaitable<T, sizeof...(Tasks) + 1> when_any(async<T> task, Tasks... tasks) noexcept
+{
+  return { { std::move(task), std::move(tasks)... }, nullptr };
+}
+
+template <typename T, std::same_as<async<T>>... Tasks>
+[[nodiscard]] detail::when_any_awaitable<T, sizeof...(Tasks) + 1> when_any(
+  cancellation_source& source, async<T> task, Tasks... tasks) noexcept
+{
+  return { { std::move(task), std::move(tasks)... }, &source };
+}
+
+// Starts all tasks and resumes with the index and result of the first task that completed. The range must not be
+// empty.
+template <typename T>
+[[nodiscard]] detail::when_any_awaitable<T, std::dynamic_extent> when_any(std::vector<async<T>> tasks) noexcept
+{
+  return { std::move(tasks), nullptr };
+}
+
+template <typename T>
+[[nodiscard]] detail::when_any_awaitable<T, std::dynamic_extent> when_any(
+  cancellation_source& source, std::vector<async<T>> tasks) noexcept
+{
+  return { std::move(tasks), &source };
+}
+
+}  // namespace ice
@@ -0,0 +1,138 @@
+#include "ice/cancellation.hpp"
+#include <new>
+#include <thread>
+
+namespace ice {
+namespace {
+
+detail::cancellation_state* acquire(detail::cancellation_state* state) noexcept
+{
+  if (state) {
+    state->references.fetch_add(1, std::memory_order_relaxed);
+  }
+  return state;
+}
+
+void release(detail::cancellation_state* state) noexcept
+{
+  if (state && state->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete state;
+  }
+}
+
+}  // namespace
+
+cancellation_token::cancellation_token(const cancellation_token& other) noexcept : state_(acquire(other.state_)) {}
+
+cancellation_token& cancellation_token::operator=(cancellation_token&& other) noexcept
+{
+  if (this != &other) {
+    release(std::exchange(state_, std::exchange(other.state_, nullptr)));
+  }
+  return *this;
+}
+
+cancellation_token& cancellation_token::operator=(const cancellation_token& other) noexcept
+{
+  if (state_ != other.state_) {
+    release(std::exchange(state_, acquire(other.state_)));
+  }
+  return *this;
+}
+
+cancellation_token::~cancellation_token()
+{
+  release(state_);
+}
+
+cancellation_token::cancellation_token(detail::cancellation_state* state) noexcept : state_(acquire(state)) {}
+
+cancellation_source::cancellation_source() noexcept : state_(new (std::nothrow) detail::cancellation_state) {}
+
+cancellation_source::cancellation_source(const cancellation_source& other) noexcept : state_(acquire(other.state_)) {}
+
+cancellation_source& cancellation_source::operator=(cancellation_source&& other) noexcept
+{
+  if (this != &other) {
+    release(std::exchange(state_, std::exchange(other.state_, nullptr)));
+  }
+  return *this;
+}
+
+cancellation_source& cancellation_source::operator=(const cancellation_source& other) noexcept
+{
+  if (state_ != other.state_) {
+    release(std::exchange(state_, acquire(other.state_)));
+  }
+  return *this;
+}
+
+cancellation_source::~cancellation_source()
+{
+  release(state_);
+}
+
+void cancellation_source::request_cancellation() noexcept
+{
+  if (!state_ || state_->requested.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  cancellation_registration* head = nullptr;
+  {
+    std::lock_guard lock{ state_->mutex };
+    head = std::exchange(state_->head, nullptr);
+    for (auto registration = head; registration; registration = registration->next_) {
+      registration->link_ = nullptr;
+    }
+  }
+  // A callback can resume the awaiter and destroy the registration.
+  while (head) {
+    const auto next = head->next_;
+    head->callback_(*head);
+    head = next;
+  }
+}
+
+bool cancellation_registration::attach(const cancellation_token& token) noexcept
+{
+  const auto state = token.state_;
+  if (!state) {
+    return true;
+  }
+  std::lock_guard lock{ state->mutex };
+  if (state->requested.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  state_ = state;
+  next_ = state->head;
+  link_ = &state->head;
+  if (next_) {
+    next_->link_ = &next_;
+  }
+  state->head = this;
+  return true;
+}
+
+void cancellation_registration::detach() noexcept
+{
+  const auto state = std::exchange(state_, nullptr);
+  if (!state) {
+    return;
+  }
+  {
+    std::lock_guard lock{ state->mutex };
+    if (link_) {
+      *link_ = next_;
+      if (next_) {
+        next_->link_ = link_;
+      }
+      link_ = nullptr;
+      return;
+    }
+  }
+  while (!released_.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace ice
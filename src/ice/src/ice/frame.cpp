@@ -0,0 +1,146 @@
+#include "ice/frame.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace ice {
+namespace {
+
+// Every frame is prefixed with the arena that it was allocated from.
+constexpr std::size_t header = frame_arena::alignment;
+
+// Maximum number of frames that are kept per size class and thread.
+constexpr std::uint32_t pool_limit = 256;
+
+struct pool_block {
+  pool_block* next;
+};
+
+// Trivially destructible, so that frames can still be freed while the thread exits.
+struct pool {
+  pool_block* blocks[frame_arena::classes];
+  std::uint32_t sizes[frame_arena::classes];
+  bool registered;
+  bool closed;
+};
+
+thread_local pool g_pool;
+
+struct pool_cleanup {
+  ~pool_cleanup()
+  {
+    g_pool.closed = true;
+    for (std::size_t i = 0; i < frame_arena::classes; i++) {
+      while (const auto block = g_pool.blocks[i]) {
+        g_pool.blocks[i] = block->next;
+        ::operator delete(block);
+      }
+      g_pool.sizes[i] = 0;
+    }
+  }
+};
+
+thread_local pool_cleanup g_pool_cleanup;
+
+constexpr std::size_t size_class(std::size_t size) noexcept
+{
+  return (size - 1) / frame_arena::granularity;
+}
+
+void* pool_allocate(std::size_t size)
+{
+  const auto index = size_class(size);
+  if (index >= frame_arena::classes) {
+    return ::operator new(size);
+  }
+  if (const auto block = g_pool.blocks[index]) {
+    g_pool.blocks[index] = block->next;
+    g_pool.sizes[index]--;
+    return block;
+  }
+  return ::operator new((index + 1) * frame_arena::granularity);
+}
+
+void pool_deallocate(void* data, std::size_t size) noexcept
+{
+  const auto index = size_class(size);
+  if (index >= frame_arena::classes || g_pool.closed || g_pool.sizes[index] >= pool_limit) {
+    ::operator delete(data);
+    return;
+  }
+  if (!g_pool.registered) {
+    g_pool.registered = true;
+    static_cast<void>(&g_pool_cleanup);
+  }
+  const auto block = static_cast<pool_block*>(data);
+  block->next = g_pool.blocks[index];
+  g_pool.blocks[index] = block;
+  g_pool.sizes[index]++;
+}
+
+}  // namespace
+
+frame_arena::~frame_arena()
+{
+  while (const auto chunk = chunks_) {
+    chunks_ = chunk->next;
+    ::operator delete(chunk);
+  }
+}
+
+void* frame_arena::allocate(std::size_t size)
+{
+  const auto index = size_class(size);
+  if (index >= classes) {
+    return ::operator new(size);
+  }
+  if (const auto block = blocks_[index]) {
+    blocks_[index] = block->next;
+    return block;
+  }
+  size = (index + 1) * granularity;
+  if (size > size_) {
+    const auto capacity = std::max(chunk_, size);
+    const auto chunk = static_cast<block*>(::operator new(header + capacity));
+    chunk->next = chunks_;
+    chunks_ = chunk;
+    data_ = reinterpret_cast<char*>(chunk) + header;
+    size_ = capacity;
+  }
+  const auto data = data_;
+  data_ += size;
+  size_ -= size;
+  return data;
+}
+
+void frame_arena::deallocate(void* data, std::size_t size) noexcept
+{
+  const auto index = size_class(size);
+  if (index >= classes) {
+    ::operator delete(data);
+    return;
+  }
+  const auto entry = static_cast<block*>(data);
+  entry->next = blocks_[index];
+  blocks_[index] = entry;
+}
+
+void* allocate_frame(std::size_t size, frame_arena* arena)
+{
+  const auto data = static_cast<char*>(arena ? arena->allocate(header + size) : pool_allocate(header + size));
+  *reinterpret_cast<frame_arena**>(data) = arena;
+  return data + header;
+}
+
+void deallocate_frame(void* frame, std::size_t size) noexcept
+{
+  assert(frame);
+  const auto data = static_cast<char*>(frame) - header;
+  if (const auto arena = *reinterpret_cast<frame_arena**>(data)) {
+    arena->deallocate(data, header + size);
+    return;
+  }
+  pool_deallocate(data, header + size);
+}
+
+}  // namespace ice
@@ -131,4 +131,19 @@ int option::reuse_address::name() const noexcept
   return SO_REUSEADDR;
 }
 
+#if !ICE_OS_WIN32
+
+int option::reuse_port::name() const noexcept
+{
+#  if ICE_OS_FREEBSD
+  // SO_REUSEPORT only allows binding to the same port on FreeBSD. The kernel distributes connections between the
+  // sockets with SO_REUSEPORT_LB.
+  return SO_REUSEPORT_LB;
+#  else
+  return SO_REUSEPORT;
+#  endif
+}
+
+#endif
+
 }  // namespace ice::net
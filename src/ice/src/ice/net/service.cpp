@@ -1,6 +1,9 @@
 #include "ice/net/service.hpp"
 #include <ice/error.hpp>
 #include <ice/net/event.hpp>
+#include <ice/net/uring.hpp>
+#include <new>
+#include <utility>
 #include <vector>
 #include <cassert>
 #include <ctime>
@@ -34,8 +37,20 @@ void service::close_type::operator()(int handle) noexcept
 }
 #endif
 
-std::error_code service::create() noexcept
+service::service() = default;
+
+service::~service()
 {
+#if !ICE_OS_WIN32
+  while (registrations_) {
+    delete std::exchange(registrations_, registrations_->next);
+  }
+#endif
+}
+
+std::error_code service::create(bool uring) noexcept
+{
+  (void)uring;
 #if ICE_OS_WIN32
   struct wsa {
     wsa() noexcept
@@ -56,7 +71,7 @@ std::error_code service::create() noexcept
   if (wsa.ec) {
     return wsa.ec;
   }
-  handle_type handle(::CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1));
+  handle_type handle(::CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 0));
   if (!handle) {
     return make_error_code(::GetLastError());
   }
@@ -74,6 +89,19 @@ std::error_code service::create() noexcept
     return make_error_code(errno);
   }
   events_ = std::move(events);
+#  if ICE_URING
+  if (uring) {
+    // Fall back to readiness notifications when the kernel does not support or permit io_uring.
+    if (auto ring = std::unique_ptr<net::uring>(new (std::nothrow) net::uring); ring && !ring->create(256)) {
+      nev = { EPOLLIN | EPOLLET, {} };
+      nev.data.ptr = ring.get();
+      if (::epoll_ctl(handle, EPOLL_CTL_ADD, ring->events(), &nev) < 0) {
+        return make_error_code(errno);
+      }
+      uring_ = std::move(ring);
+    }
+  }
+#  endif
 #elif ICE_OS_FREEBSD
   handle_type handle(::kqueue());
   if (!handle) {
@@ -110,41 +138,50 @@ std::error_code service::run(std::size_t event_buffer_size) noexcept
   const auto events_size = static_cast<size_type>(events.size());
   auto stop = stop_.load(std::memory_order_acquire);
 
-#if ICE_OS_FREEBSD
-  const timespec ts = { 0, 1000000 };
-#endif
-
   while (true) {
+    // Posts that happen after this point interrupt the wait. Posts that happened before it are already visible
+    // in the queue and make the wait return immediately.
+    sleeping_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto ready = !empty();
+    const auto timeout = ready ? 0 : stop ? 1 : scheduler::timeout();
 #if ICE_OS_WIN32
     size_type count = 0;
-    const DWORD timeout = stop ? 1 : INFINITE;
-    if (!::GetQueuedCompletionStatusEx(handle_.as<HANDLE>(), events_data, events_size, &count, timeout, FALSE)) {
+    const auto wait = timeout < 0 ? INFINITE : static_cast<DWORD>(timeout);
+    const auto rv = ::GetQueuedCompletionStatusEx(handle_.as<HANDLE>(), events_data, events_size, &count, wait, FALSE);
+    awake();
+    if (!rv) {
       if (const auto rc = ::GetLastError(); rc != ERROR_ABANDONED_WAIT_0 && rc != WAIT_TIMEOUT) {
         return make_error_code(rc);
+      } else if (rc == ERROR_ABANDONED_WAIT_0 || (stop && !ready)) {
+        break;
       }
-      break;
-    }
-    if (count < 1) {
+      count = 0;
+    } else if (count < 1) {
       break;
     }
 #else
 #  if ICE_OS_LINUX
-    const auto timeout = stop ? 1 : -1;
+#    if ICE_URING
+    if (uring_) {
+      uring_->submit();
+    }
+#    endif
     const auto count = ::epoll_wait(handle_, events_data, events_size, timeout);
 #  elif ICE_OS_FREEBSD
-    const auto timeout = stop ? &ts : nullptr;
-    const auto count = ::kevent(handle_, nullptr, 0, events_data, events_size, timeout);
+    const timespec ts = { timeout / 1000, timeout % 1000 * 1000000 };
+    const auto count = ::kevent(handle_, nullptr, 0, events_data, events_size, timeout < 0 ? nullptr : &ts);
 #  endif
+    awake();
     if (count < 1) {
       if (count < 0 && errno != EINTR) {
         return make_error_code(errno);
       }
-      if (stop_.load(std::memory_order_acquire)) {
+      if (!ready && stop_.load(std::memory_order_acquire)) {
         break;
       }
     }
 #endif
-    auto interrupted = false;
     for (size_type i = 0; i < count; i++) {
       auto& entry = events_data[i];
 #if ICE_OS_WIN32
@@ -153,26 +190,100 @@ std::error_code service::run(std::size_t event_buffer_size) noexcept
         continue;
       }
 #elif ICE_OS_LINUX
-      if (const auto ev = reinterpret_cast<event*>(entry.data.ptr)) {
-        ev->resume();
+#  if ICE_URING
+      if (uring_ && entry.data.ptr == uring_.get()) {
+        uring_->process();
+        continue;
+      }
+#  endif
+      if (const auto registration = reinterpret_cast<net::registration*>(entry.data.ptr)) {
+        registration->notify(entry.events);
         continue;
       }
 #elif ICE_OS_FREEBSD
-      if (const auto ev = reinterpret_cast<event*>(entry.udata)) {
-        ev->resume();
+      if (const auto registration = reinterpret_cast<net::registration*>(entry.udata)) {
+        registration->notify(entry.filter);
         continue;
       }
 #endif
-      interrupted = true;
       stop = stop_.load(std::memory_order_acquire);
     }
-    if (interrupted) {
-      process();
+    expire();
+    process();
+  }
+
+  // Passes the stop request on to the next thread that runs the service.
+  return interrupt();
+}
+
+void service::awake() noexcept
+{
+  // Gives up the claim of this thread unless a post already took one. When the claim of another waiting thread is
+  // taken instead, this thread is running and processes the ready queue before it waits again.
+  auto sleeping = sleeping_.load(std::memory_order_relaxed);
+  while (sleeping) {
+    if (sleeping_.compare_exchange_weak(sleeping, sleeping - 1, std::memory_order_relaxed)) {
+      break;
+    }
+  }
+}
+
+#if !ICE_OS_WIN32
+
+registration* service::attach(int handle, std::error_code& ec) noexcept
+{
+  ec.clear();
+  net::registration* registration = nullptr;
+  {
+    std::lock_guard lock{ registrations_mutex_ };
+    if (registrations_) {
+      registration = std::exchange(registrations_, registrations_->next);
     }
   }
-  return {};
+  if (registration) {
+    registration->recv.store(registration::idle, std::memory_order_relaxed);
+    registration->send.store(registration::idle, std::memory_order_relaxed);
+    registration->handle = handle;
+    registration->next = nullptr;
+  } else {
+    registration = new (std::nothrow) net::registration{ *this, handle };
+    if (!registration) {
+      ec = make_error_code(std::errc::not_enough_memory);
+      return nullptr;
+    }
+  }
+#  if ICE_OS_LINUX
+  epoll_event nev = { EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, {} };
+  nev.data.ptr = registration;
+  if (::epoll_ctl(handle_, EPOLL_CTL_ADD, handle, &nev) < 0) {
+    ec = make_error_code(errno);
+  }
+#  elif ICE_OS_FREEBSD
+  struct kevent nev[2];
+  EV_SET(&nev[0], static_cast<uintptr_t>(handle), EVFILT_READ, EV_ADD | EV_CLEAR, 0, 0, registration);
+  EV_SET(&nev[1], static_cast<uintptr_t>(handle), EVFILT_WRITE, EV_ADD | EV_CLEAR, 0, 0, registration);
+  if (::kevent(handle_, nev, 2, nullptr, 0, nullptr) < 0) {
+    ec = make_error_code(errno);
+  }
+#  endif
+  if (ec) {
+    detach(registration);
+    return nullptr;
+  }
+  return registration;
+}
+
+void service::detach(registration* registration) noexcept
+{
+  // The kernel drops the registration when the descriptor is closed. Registrations are never freed while the
+  // service is alive, so events that were already dequeued for a closed descriptor only mark a slot as ready.
+  std::lock_guard lock{ registrations_mutex_ };
+  registration->next = registrations_;
+  registrations_ = registration;
 }
 
+#endif
+
 std::error_code service::interrupt() noexcept
 {
 #if ICE_OS_WIN32
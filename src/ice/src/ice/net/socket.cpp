@@ -1,4 +1,5 @@
 #include "ice/net/socket.hpp"
+#include <ice/net/event.hpp>
 
 #if ICE_OS_WIN32
 #  include <windows.h>
@@ -30,6 +31,11 @@ void socket::close_type::operator()(int handle) noexcept
   }
 }
 
+void socket::detach_type::operator()(net::registration* registration) noexcept
+{
+  registration->service.detach(registration);
+}
+
 #endif
 
 std::error_code socket::create(int family, int type, int protocol) noexcept
@@ -50,6 +56,7 @@ std::error_code socket::create(int family, int type, int protocol) noexcept
   if (!handle) {
     return make_error_code(errno);
   }
+  registration_.reset();
 #endif
   handle_ = std::move(handle);
   return {};
@@ -139,6 +146,18 @@ endpoint socket::name() const noexcept
   return endpoint;
 }
 
+#if !ICE_OS_WIN32
+
+net::registration* socket::registration(std::error_code& ec) noexcept
+{
+  if (!registration_) {
+    registration_.reset(service().attach(handle_, ec));
+  }
+  return registration_;
+}
+
+#endif
+
 std::error_code socket::get(int level, int name, void* data, socklen_t& size) const noexcept
 {
 #if ICE_OS_WIN32
@@ -1,5 +1,7 @@
 #include "ice/net/tcp/socket.hpp"
 #include <ice/net/event.hpp>
+#include <ice/net/uring.hpp>
+#include <algorithm>
 #include <array>
 #include <cassert>
 
@@ -13,12 +15,67 @@
 #  include <netinet/in.h>
 #  include <sys/socket.h>
 #  include <sys/types.h>
+#  include <sys/uio.h>
 #  include <unistd.h>
+#  include <climits>
+#  if ICE_OS_LINUX
+#    include <linux/errqueue.h>
+#    include <netinet/in.h>
+#    include <sys/sendfile.h>
+#  endif
+#endif
+
+#if ICE_URING
+#  include <limits>
 #endif
 
 namespace ice::net::tcp {
 namespace detail {
 
+// Advances the position in the buffers by the given number of bytes and skips empty buffers.
+void advance(std::span<const buffer> buffers, std::size_t& index, std::size_t& offset, std::size_t bytes) noexcept
+{
+  offset += bytes;
+  while (index < buffers.size() && offset >= buffers[index].size) {
+    offset -= buffers[index].size;
+    index++;
+  }
+}
+
+#if ICE_OS_LINUX
+
+// Reads all zero-copy completion notifications from the error queue and returns the number of completed sends.
+// Each notification covers an inclusive range of send calls on the socket.
+std::uint32_t zerocopy_completions(int handle) noexcept
+{
+  std::uint32_t count = 0;
+  while (true) {
+    alignas(::cmsghdr) std::array<char, CMSG_SPACE(sizeof(::sock_extended_err))> control;
+    ::msghdr msg = {};
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    if (::recvmsg(handle, &msg, MSG_ERRQUEUE) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+        continue;
+      }
+      const auto error = reinterpret_cast<const ::sock_extended_err*>(CMSG_DATA(cmsg));
+      if (error->ee_origin == SO_EE_ORIGIN_ZEROCOPY) {
+        count += error->ee_data - error->ee_info + 1;
+      }
+    }
+  }
+  return count;
+}
+
+#endif
+
 #if ICE_OS_WIN32
 
 struct connect_ex {
@@ -86,7 +143,7 @@ std::error_code socket::listen(std::size_t backlog) noexcept
 
 #if ICE_OS_WIN32
 
-async<socket> socket::accept(endpoint& endpoint) noexcept
+async<socket> socket::accept(endpoint& endpoint, timer::time_point deadline, cancellation_token token) noexcept
 {
   constexpr static DWORD buffer_size = sockaddr_storage_size + 16;
   std::array<char, buffer_size * 2> buffer;
@@ -99,7 +156,7 @@ async<socket> socket::accept(endpoint& endpoint) noexcept
   const auto server_socket = handle().as<SOCKET>();
   const auto client_socket = client.handle().as<SOCKET>();
   while (true) {
-    event ev;
+    event ev{ *this, deadline, token };
     if (::AcceptEx(server_socket, client_socket, &buffer, 0, buffer_size, buffer_size, &bytes, &ev)) {
       break;
     }
@@ -129,7 +186,32 @@ async<socket> socket::accept(endpoint& endpoint) noexcept
   co_return std::move(client);
 }
 
-async<std::error_code> socket::connect(const endpoint& endpoint) noexcept
+async<std::size_t> socket::accept(
+  std::vector<socket>& clients, std::size_t size, timer::time_point deadline, cancellation_token token,
+  std::error_code& ec) noexcept
+{
+  ec.clear();
+  if (!size) {
+    co_return 0;
+  }
+  endpoint endpoint;
+  auto client = co_await accept(endpoint, deadline, token);
+  if (!client) {
+    if (token.is_cancellation_requested()) {
+      ec = make_error_code(std::errc::operation_canceled);
+    } else if (timer::clock::now() >= deadline) {
+      ec = make_error_code(std::errc::timed_out);
+    } else {
+      ec = make_error_code(std::errc::connection_aborted);
+    }
+    co_return 0;
+  }
+  clients.push_back(std::move(client));
+  co_return 1;
+}
+
+async<std::error_code> socket::connect(
+  const endpoint& endpoint, timer::time_point deadline, cancellation_token token) noexcept
 {
   static const detail::connect_ex connect;
   if (connect.ec) {
@@ -144,7 +226,7 @@ async<std::error_code> socket::connect(const endpoint& endpoint) noexcept
   if (::bind(client_socket, reinterpret_cast<const SOCKADDR*>(&addr), sizeof(addr)) == SOCKET_ERROR) {
     co_return make_error_code(::WSAGetLastError());
   }
-  event ev;
+  event ev{ *this, deadline, token };
   if (connect(client_socket, &endpoint.sockaddr(), endpoint.size(), nullptr, 0, nullptr, &ev)) {
     co_return{};
   }
@@ -154,12 +236,13 @@ async<std::error_code> socket::connect(const endpoint& endpoint) noexcept
   co_await ev;
   DWORD bytes = 0;
   if (!::GetOverlappedResult(client_handle, &ev, &bytes, FALSE)) {
-    co_return make_error_code(::GetLastError());
+    co_return ev.error(::GetLastError());
   }
   co_return{};
 }
 
-async<std::size_t> socket::recv(char* data, std::size_t size, std::error_code& ec) noexcept
+async<std::size_t> socket::recv(
+  char* data, std::size_t size, timer::time_point deadline, cancellation_token token, std::error_code& ec) noexcept
 {
   ec.clear();
   const auto handle = handle_.as<HANDLE>();
@@ -167,7 +250,7 @@ async<std::size_t> socket::recv(char* data, std::size_t size, std::error_code& e
   WSABUF buffer = { static_cast<ULONG>(size), data };
   DWORD bytes = 0;
   DWORD flags = 0;
-  event ev;
+  event ev{ *this, deadline, token };
   if (::WSARecv(socket, &buffer, 1, &bytes, &flags, &ev, nullptr) != SOCKET_ERROR) {
     co_return bytes;
   }
@@ -177,13 +260,15 @@ async<std::size_t> socket::recv(char* data, std::size_t size, std::error_code& e
   }
   co_await ev;
   if (!::GetOverlappedResult(handle, &ev, &bytes, FALSE)) {
-    ec = make_error_code(::WSAGetLastError());
+    ec = ev.error(::WSAGetLastError());
     co_return{};
   }
   co_return bytes;
 }
 
-async<std::size_t> socket::send(const char* data, std::size_t size, std::error_code& ec) noexcept
+async<std::size_t> socket::send(
+  const char* data, std::size_t size, timer::time_point deadline, cancellation_token token,
+  std::error_code& ec) noexcept
 {
   ec.clear();
   const auto handle = handle_.as<HANDLE>();
@@ -191,7 +276,7 @@ async<std::size_t> socket::send(const char* data, std::size_t size, std::error_c
   WSABUF buffer = { static_cast<ULONG>(size), const_cast<char*>(data) };
   DWORD bytes = 0;
   do {
-    event ev;
+    event ev{ *this, deadline, token };
     if (::WSASend(socket, &buffer, 1, &bytes, 0, &ev, nullptr) == SOCKET_ERROR) {
       if (const auto rc = ::WSAGetLastError(); rc != ERROR_IO_PENDING) {
         ec = make_error_code(rc);
@@ -199,7 +284,7 @@ async<std::size_t> socket::send(const char* data, std::size_t size, std::error_c
       }
       co_await ev;
       if (!::GetOverlappedResult(handle, &ev, &bytes, FALSE)) {
-        ec = make_error_code(::WSAGetLastError());
+        ec = ev.error(::WSAGetLastError());
         break;
       }
     }
@@ -212,9 +297,110 @@ async<std::size_t> socket::send(const char* data, std::size_t size, std::error_c
   co_return static_cast<std::size_t>(size - buffer.len);
 }
 
+async<std::size_t> socket::recv(
+  std::span<const buffer> buffers, timer::time_point deadline, cancellation_token token, std::error_code& ec) noexcept
+{
+  ec.clear();
+  const auto handle = handle_.as<HANDLE>();
+  const auto socket = handle_.as<SOCKET>();
+  const auto data = reinterpret_cast<LPWSABUF>(const_cast<buffer*>(buffers.data()));
+  DWORD bytes = 0;
+  DWORD flags = 0;
+  event ev{ *this, deadline, token };
+  if (::WSARecv(socket, data, static_cast<DWORD>(buffers.size()), &bytes, &flags, &ev, nullptr) != SOCKET_ERROR) {
+    co_return bytes;
+  }
+  if (const auto rc = ::WSAGetLastError(); rc != ERROR_IO_PENDING) {
+    ec = make_error_code(rc);
+    co_return{};
+  }
+  co_await ev;
+  if (!::GetOverlappedResult(handle, &ev, &bytes, FALSE)) {
+    ec = ev.error(::WSAGetLastError());
+    co_return{};
+  }
+  co_return bytes;
+}
+
+async<std::size_t> socket::send(
+  std::span<const buffer> buffers, timer::time_point deadline, cancellation_token token, std::error_code& ec) noexcept
+{
+  ec.clear();
+  const auto handle = handle_.as<HANDLE>();
+  const auto socket = handle_.as<SOCKET>();
+  std::size_t index = 0;
+  std::size_t offset = 0;
+  std::size_t sent = 0;
+  detail::advance(buffers, index, offset, 0);
+  while (index < buffers.size()) {
+    // A partially sent buffer is continued on its own before the remaining buffers are sent together.
+    WSABUF remainder = { static_cast<ULONG>(buffers[index].size - offset), buffers[index].data + offset };
+    auto data = reinterpret_cast<LPWSABUF>(const_cast<buffer*>(buffers.data() + index));
+    auto size = static_cast<DWORD>(buffers.size() - index);
+    if (offset) {
+      data = &remainder;
+      size = 1;
+    }
+    DWORD bytes = 0;
+    event ev{ *this, deadline, token };
+    if (::WSASend(socket, data, size, &bytes, 0, &ev, nullptr) == SOCKET_ERROR) {
+      if (const auto rc = ::WSAGetLastError(); rc != ERROR_IO_PENDING) {
+        ec = make_error_code(rc);
+        break;
+      }
+      co_await ev;
+      if (!::GetOverlappedResult(handle, &ev, &bytes, FALSE)) {
+        ec = ev.error(::WSAGetLastError());
+        break;
+      }
+    }
+    if (bytes == 0) {
+      break;
+    }
+    sent += bytes;
+    detail::advance(buffers, index, offset, bytes);
+  }
+  co_return sent;
+}
+
+async<std::size_t> socket::send_file(
+  file_handle file, std::uint64_t offset, std::size_t size, timer::time_point deadline, cancellation_token token,
+  std::error_code& ec) noexcept
+{
+  ec.clear();
+  const auto handle = handle_.as<HANDLE>();
+  const auto socket = handle_.as<SOCKET>();
+  const auto data_size = size;
+  while (size > 0) {
+    // TransmitFile sends at most 2^31 - 2 bytes per call.
+    const auto chunk = static_cast<DWORD>(std::min<std::size_t>(size, 0x7FFFFFFE));
+    DWORD bytes = 0;
+    event ev{ *this, deadline, token };
+    ev.Offset = static_cast<DWORD>(offset);
+    ev.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    if (!::TransmitFile(socket, file, chunk, 0, &ev, nullptr, 0)) {
+      if (const auto rc = ::WSAGetLastError(); rc != ERROR_IO_PENDING) {
+        ec = make_error_code(rc);
+        break;
+      }
+      co_await ev;
+    }
+    if (!::GetOverlappedResult(handle, &ev, &bytes, FALSE)) {
+      ec = ev.error(::WSAGetLastError());
+      break;
+    }
+    if (bytes == 0) {
+      break;
+    }
+    offset += bytes;
+    size -= bytes;
+  }
+  co_return data_size - size;
+}
+
 #else
 
-async<socket> socket::accept(endpoint& endpoint) noexcept
+async<socket> socket::accept(endpoint& endpoint, timer::time_point deadline, cancellation_token token) noexcept
 {
   socket client{ service() };
   while (true) {
@@ -229,19 +415,91 @@ async<socket> socket::accept(endpoint& endpoint) noexcept
     if (errno != EAGAIN) {
       break;
     }
-    if (co_await event{ service(), handle(), ICE_EVENT_RECV }) {
+#  if ICE_URING
+    if (service().uring()) {
+      uring::operation operation{ service(), IORING_OP_ACCEPT, handle(), deadline, token };
+      operation.address = &endpoint.sockaddr();
+      operation.offset = reinterpret_cast<std::uintptr_t>(&endpoint.size());
+      operation.flags = SOCK_NONBLOCK;
+      if (const auto rc = co_await operation; rc >= 0) {
+        client.handle_.reset(rc);
+        break;
+      } else if (rc != -EINTR && rc != -EAGAIN) {
+        break;
+      }
+      continue;
+    }
+#  endif
+    if (co_await event{ *this, ICE_EVENT_RECV, deadline, token }) {
       break;
     }
   }
   co_return std::move(client);
 }
 
-async<std::error_code> socket::connect(const endpoint& endpoint) noexcept
+async<std::size_t> socket::accept(
+  std::vector<socket>& clients, std::size_t size, timer::time_point deadline, cancellation_token token,
+  std::error_code& ec) noexcept
 {
+  ec.clear();
+  std::size_t count = 0;
+  while (count < size) {
+    socket client{ service() };
+    client.handle_.reset(::accept4(handle(), nullptr, nullptr, SOCK_NONBLOCK));
+    if (client) {
+      clients.push_back(std::move(client));
+      count++;
+      continue;
+    }
+    if (errno == EINTR || errno == ECONNABORTED) {
+      continue;
+    }
+    if (errno != EAGAIN) {
+      if (!count) {
+        ec = make_error_code(errno);
+      }
+      break;
+    }
+    if (count) {
+      break;
+    }
+    // Wait for readiness instead of submitting an accept operation, so that the backlog is drained with accept4
+    // once the wait completed.
+    if (const auto rc = co_await event{ *this, ICE_EVENT_RECV, deadline, token }) {
+      ec = rc;
+      break;
+    }
+  }
+  co_return count;
+}
+
+async<std::error_code> socket::connect(
+  const endpoint& endpoint, timer::time_point deadline, cancellation_token token) noexcept
+{
+#  if ICE_URING
+  if (service().uring()) {
+    uring::operation operation{ service(), IORING_OP_CONNECT, handle(), deadline, token };
+    operation.address = &endpoint.sockaddr();
+    operation.offset = endpoint.size();
+    const auto rc = co_await operation;
+    if (rc == 0) {
+      co_return{};
+    }
+    // Kernels before 6.2 report a connection in progress on non-blocking sockets.
+    if (rc != -EINPROGRESS && rc != -EALREADY) {
+      co_return operation.error();
+    }
+  }
+#  endif
   while (true) {
     if (::connect(handle(), &endpoint.sockaddr(), endpoint.size()) == 0) {
       co_return{};
     }
+#  if ICE_URING
+    if (errno == EALREADY || errno == EISCONN) {
+      errno = EINPROGRESS;
+    }
+#  endif
 #  if ICE_OS_LINUX
     if (errno == EINTR) {
       continue;
@@ -254,7 +512,7 @@ async<std::error_code> socket::connect(const endpoint& endpoint) noexcept
       co_return make_error_code(errno);
     }
 #  endif
-    if (const auto ec = co_await event{ service(), handle(), ICE_EVENT_SEND }) {
+    if (const auto ec = co_await event{ *this, ICE_EVENT_SEND, deadline, token }) {
       co_return ec;
     }
     auto code = 0;
@@ -270,7 +528,8 @@ async<std::error_code> socket::connect(const endpoint& endpoint) noexcept
   co_return{};
 }
 
-async<std::size_t> socket::recv(char* data, std::size_t size, std::error_code& ec) noexcept
+async<std::size_t> socket::recv(
+  char* data, std::size_t size, timer::time_point deadline, cancellation_token token, std::error_code& ec) noexcept
 {
   ec.clear();
   while (true) {
@@ -284,7 +543,21 @@ async<std::size_t> socket::recv(char* data, std::size_t size, std::error_code& e
       ec = make_error_code(errno);
       break;
     }
-    if (const auto rc = co_await event{ service(), handle(), ICE_EVENT_RECV }) {
+#  if ICE_URING
+    if (service().uring()) {
+      uring::operation operation{ service(), IORING_OP_RECV, handle(), deadline, token };
+      operation.address = data;
+      operation.size = static_cast<std::uint32_t>(std::min<std::size_t>(size, std::numeric_limits<int>::max()));
+      if (const auto rc = co_await operation; rc >= 0) {
+        co_return static_cast<std::size_t>(rc);
+      } else if (rc != -EINTR && rc != -EAGAIN) {
+        ec = operation.error();
+        break;
+      }
+      continue;
+    }
+#  endif
+    if (const auto rc = co_await event{ *this, ICE_EVENT_RECV, deadline, token }) {
       ec = rc;
       break;
     }
@@ -292,7 +565,9 @@ async<std::size_t> socket::recv(char* data, std::size_t size, std::error_code& e
   co_return{};
 }
 
-async<std::size_t> socket::send(const char* data, std::size_t size, std::error_code& ec) noexcept
+async<std::size_t> socket::send(
+  const char* data, std::size_t size, timer::time_point deadline, cancellation_token token,
+  std::error_code& ec) noexcept
 {
   ec.clear();
   const auto data_size = size;
@@ -300,6 +575,7 @@ async<std::size_t> socket::send(const char* data, std::size_t size, std::error_c
     if (const auto rc = ::write(handle(), data, size); rc > 0) {
       data += static_cast<std::size_t>(rc);
       size -= static_cast<std::size_t>(rc);
+      continue;
     } else if (rc == 0) {
       break;
     }
@@ -310,7 +586,24 @@ async<std::size_t> socket::send(const char* data, std::size_t size, std::error_c
       ec = make_error_code(errno);
       break;
     }
-    if (const auto rc = co_await event{ service(), handle(), ICE_EVENT_SEND }) {
+#  if ICE_URING
+    if (service().uring()) {
+      uring::operation operation{ service(), IORING_OP_SEND, handle(), deadline, token };
+      operation.address = data;
+      operation.size = static_cast<std::uint32_t>(std::min<std::size_t>(size, std::numeric_limits<int>::max()));
+      if (const auto rc = co_await operation; rc > 0) {
+        data += static_cast<std::size_t>(rc);
+        size -= static_cast<std::size_t>(rc);
+      } else if (rc == 0) {
+        break;
+      } else if (rc != -EINTR && rc != -EAGAIN) {
+        ec = operation.error();
+        break;
+      }
+      continue;
+    }
+#  endif
+    if (const auto rc = co_await event{ *this, ICE_EVENT_SEND, deadline, token }) {
       ec = rc;
       break;
     }
@@ -318,6 +611,230 @@ async<std::size_t> socket::send(const char* data, std::size_t size, std::error_c
   co_return data_size - size;
 }
 
+async<std::size_t> socket::recv(
+  std::span<const buffer> buffers, timer::time_point deadline, cancellation_token token, std::error_code& ec) noexcept
+{
+  ec.clear();
+  const auto data = reinterpret_cast<const ::iovec*>(buffers.data());
+  const auto size = static_cast<int>(std::min<std::size_t>(buffers.size(), IOV_MAX));
+  while (true) {
+    if (const auto rc = ::readv(handle(), data, size); rc >= 0) {
+      co_return static_cast<std::size_t>(rc);
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (errno != EAGAIN) {
+      ec = make_error_code(errno);
+      break;
+    }
+#  if ICE_URING
+    if (service().uring()) {
+      uring::operation operation{ service(), IORING_OP_READV, handle(), deadline, token };
+      operation.address = data;
+      operation.size = static_cast<std::uint32_t>(size);
+      if (const auto rc = co_await operation; rc >= 0) {
+        co_return static_cast<std::size_t>(rc);
+      } else if (rc != -EINTR && rc != -EAGAIN) {
+        ec = operation.error();
+        break;
+      }
+      continue;
+    }
+#  endif
+    if (const auto rc = co_await event{ *this, ICE_EVENT_RECV, deadline, token }) {
+      ec = rc;
+      break;
+    }
+  }
+  co_return{};
+}
+
+async<std::size_t> socket::send(
+  std::span<const buffer> buffers, timer::time_point deadline, cancellation_token token, std::error_code& ec) noexcept
+{
+  ec.clear();
+  const auto data = reinterpret_cast<const ::iovec*>(buffers.data());
+  std::size_t index = 0;
+  std::size_t offset = 0;
+  std::size_t sent = 0;
+  detail::advance(buffers, index, offset, 0);
+  while (index < buffers.size()) {
+    // A partially sent buffer is continued on its own before the remaining buffers are sent together.
+    const auto size = static_cast<int>(std::min<std::size_t>(buffers.size() - index, IOV_MAX));
+    const auto rv = offset ? ::write(handle(), buffers[index].data + offset, buffers[index].size - offset) :
+                             ::writev(handle(), data + index, size);
+    if (rv > 0) {
+      sent += static_cast<std::size_t>(rv);
+      detail::advance(buffers, index, offset, static_cast<std::size_t>(rv));
+      continue;
+    } else if (rv == 0) {
+      break;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (errno != EAGAIN) {
+      ec = make_error_code(errno);
+      break;
+    }
+#  if ICE_URING
+    if (service().uring()) {
+      const std::uint8_t opcode = offset ? IORING_OP_SEND : IORING_OP_WRITEV;
+      uring::operation operation{ service(), opcode, handle(), deadline, token };
+      if (offset) {
+        const auto remainder = std::min<std::size_t>(buffers[index].size - offset, std::numeric_limits<int>::max());
+        operation.address = buffers[index].data + offset;
+        operation.size = static_cast<std::uint32_t>(remainder);
+      } else {
+        operation.address = data + index;
+        operation.size = static_cast<std::uint32_t>(size);
+      }
+      if (const auto rc = co_await operation; rc > 0) {
+        sent += static_cast<std::size_t>(rc);
+        detail::advance(buffers, index, offset, static_cast<std::size_t>(rc));
+      } else if (rc == 0) {
+        break;
+      } else if (rc != -EINTR && rc != -EAGAIN) {
+        ec = operation.error();
+        break;
+      }
+      continue;
+    }
+#  endif
+    if (const auto rc = co_await event{ *this, ICE_EVENT_SEND, deadline, token }) {
+      ec = rc;
+      break;
+    }
+  }
+  co_return sent;
+}
+
+async<std::size_t> socket::send_file(
+  file_handle file, std::uint64_t offset, std::size_t size, timer::time_point deadline, cancellation_token token,
+  std::error_code& ec) noexcept
+{
+  ec.clear();
+  const auto data_size = size;
+  while (size > 0) {
+#  if ICE_OS_LINUX
+    // Linux sends at most 0x7FFFF000 bytes per call.
+    auto position = static_cast<off_t>(offset);
+    const auto rv = ::sendfile(handle(), file, &position, std::min<std::size_t>(size, 0x7FFFF000));
+#  elif ICE_OS_FREEBSD
+    // FreeBSD reports the bytes that were sent before the socket would block together with EAGAIN.
+    off_t bytes = 0;
+    auto rv = static_cast<ssize_t>(::sendfile(file, handle(), static_cast<off_t>(offset), size, nullptr, &bytes, 0));
+    if (rv == 0 || bytes > 0) {
+      rv = static_cast<ssize_t>(bytes);
+    }
+#  endif
+    if (rv > 0) {
+      offset += static_cast<std::uint64_t>(rv);
+      size -= static_cast<std::size_t>(rv);
+      continue;
+    } else if (rv == 0) {
+      break;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (errno != EAGAIN) {
+      ec = make_error_code(errno);
+      break;
+    }
+    if (const auto rc = co_await event{ *this, ICE_EVENT_SEND, deadline, token }) {
+      ec = rc;
+      break;
+    }
+  }
+  co_return data_size - size;
+}
+
+#endif
+
+async<std::size_t> socket::send_zerocopy(
+  const char* data, std::size_t size, timer::time_point deadline, cancellation_token token,
+  std::error_code& ec) noexcept
+{
+#if ICE_OS_LINUX
+  if (!zerocopy_) {
+    constexpr int enable = 1;
+    if (set(SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable))) {
+      const auto rv = co_await send(data, size, deadline, std::move(token), ec);
+      co_return rv;
+    }
+    zerocopy_ = true;
+  }
+  ec.clear();
+
+  // The pages of the buffer stay referenced until every send call that succeeded was reported as completed, even
+  // when sending stops early because of an error, an expired deadline or a cancellation request.
+  std::size_t sent = 0;
+  std::uint32_t pending = 0;
+  auto sending = size > 0;
+  while (true) {
+    if (sending) {
+      if (const auto rv = ::send(handle(), data + sent, size - sent, MSG_ZEROCOPY); rv > 0) {
+        sent += static_cast<std::size_t>(rv);
+        sending = sent < size;
+        pending++;
+        continue;
+      } else if (rv == 0) {
+        sending = false;
+      } else if (errno == EINTR) {
+        continue;
+      } else if (errno != EAGAIN && errno != ENOBUFS) {
+        ec = make_error_code(errno);
+        sending = false;
+      }
+    }
+    pending -= detail::zerocopy_completions(handle());
+    if (!sending && !pending) {
+      break;
+    }
+
+    // Error queue notifications are reported as EPOLLERR, which wakes up the send waiter slot.
+    if (sending) {
+      if (const auto rc = co_await event{ *this, ICE_EVENT_SEND, deadline, token }) {
+        ec = rc;
+        sending = false;
+      }
+    } else if (const auto rc = co_await event{ *this, ICE_EVENT_SEND }) {
+      ec = rc;
+      break;
+    }
+  }
+  co_return sent;
+#else
+  const auto rv = co_await send(data, size, deadline, std::move(token), ec);
+  co_return rv;
+#endif
+}
+
+#if !ICE_OS_WIN32
+
+std::error_code listen(
+  std::span<net::service* const> services, const endpoint& endpoint, std::vector<socket>& sockets,
+  std::size_t backlog) noexcept
+{
+  sockets.clear();
+  sockets.reserve(services.size());
+  auto bound = endpoint;
+  for (const auto service : services) {
+    auto& server = sockets.emplace_back(*service);
+    if (auto ec = server.create(bound.family()); ec || (ec = server.set(option::reuse_port(true))) ||
+        (ec = server.bind(bound)) || (ec = server.listen(backlog))) {
+      sockets.clear();
+      return ec;
+    }
+    if (sockets.size() == 1) {
+      bound = server.name();
+    }
+  }
+  return {};
+}
+
 #endif
 
 }  // namespace ice::net::tcp
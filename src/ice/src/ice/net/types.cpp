@@ -1,4 +1,5 @@
 #include "ice/net/types.hpp"
+#include <cstddef>
 
 #if ICE_OS_WIN32
 #  include <windows.h>
@@ -9,6 +10,7 @@
 #  include <netinet/in.h>
 #  include <sys/socket.h>
 #  include <sys/types.h>
+#  include <sys/uio.h>
 #endif
 
 namespace ice::net {
@@ -17,4 +19,14 @@ static_assert(std::is_same_v<socklen_t, ::socklen_t>);
 static_assert(sockaddr_storage_size == sizeof(::sockaddr_storage));
 static_assert(sockaddr_storage_alignment == alignof(::sockaddr_storage));
 
+#if ICE_OS_WIN32
+static_assert(sizeof(buffer) == sizeof(::WSABUF));
+static_assert(offsetof(buffer, size) == offsetof(::WSABUF, len));
+static_assert(offsetof(buffer, data) == offsetof(::WSABUF, buf));
+#else
+static_assert(sizeof(buffer) == sizeof(::iovec));
+static_assert(offsetof(buffer, size) == offsetof(::iovec, iov_len));
+static_assert(offsetof(buffer, data) == offsetof(::iovec, iov_base));
+#endif
+
 }  // namespace ice::net
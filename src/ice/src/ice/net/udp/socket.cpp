@@ -0,0 +1,410 @@
+#include "ice/net/udp/socket.hpp"
+#include <ice/net/event.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if ICE_OS_WIN32
+#  include <windows.h>
+#  include <winsock2.h>
+#  include <ws2tcpip.h>
+#else
+#  include <netinet/in.h>
+#  include <sys/socket.h>
+#  include <sys/types.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+#  if ICE_OS_LINUX
+#    include <netinet/udp.h>
+#  endif
+#endif
+
+namespace ice::net::udp {
+namespace detail {
+
+#if ICE_OS_LINUX && defined(UDP_SEGMENT)
+
+// Limits of a single generic segmentation offload send. The kernel rejects more segments and payloads that do not
+// fit in one IP packet before segmentation.
+constexpr std::size_t gso_segments = 64;
+constexpr std::size_t gso_size = 65000;
+
+// Sends the data as datagrams of the given segment size with one sendmsg call.
+ssize_t send_segments(
+  int handle, const char* data, std::size_t size, std::uint16_t segment_size, const endpoint& endpoint) noexcept
+{
+  alignas(::cmsghdr) std::array<char, CMSG_SPACE(sizeof(std::uint16_t))> control = {};
+  ::iovec iov = { const_cast<char*>(data), size };
+  ::msghdr msg = {};
+  msg.msg_name = const_cast<::sockaddr*>(&endpoint.sockaddr());
+  msg.msg_namelen = endpoint.size();
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.data();
+  msg.msg_controllen = control.size();
+  const auto cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(segment_size));
+  std::memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+  return ::sendmsg(handle, &msg, 0);
+}
+
+#endif
+
+#if !ICE_OS_WIN32
+
+// Number of message headers that are passed to the kernel per system call.
+// The headers are kept on the stack, so that the coroutine frames of the batched operations stay small.
+constexpr std::size_t batch_size = 32;
+
+// Receives datagrams until the span is full or no more datagrams are queued.
+// Returns the number of received datagrams or -1 with errno set when no datagram was received.
+ssize_t recv_datagrams(int handle, std::span<datagram> datagrams) noexcept
+{
+#  if ICE_OS_LINUX && defined(UDP_GRO)
+  using control_type = std::array<char, CMSG_SPACE(sizeof(int))>;
+  alignas(::cmsghdr) std::array<control_type, batch_size> control;
+#  endif
+  std::array<::mmsghdr, batch_size> messages;
+  std::size_t count = 0;
+  while (count < datagrams.size()) {
+    const auto size = std::min(datagrams.size() - count, batch_size);
+    for (std::size_t i = 0; i < size; i++) {
+      auto& datagram = datagrams[count + i];
+      auto& msg = messages[i].msg_hdr;
+      msg = {};
+      msg.msg_name = &datagram.endpoint.sockaddr();
+      msg.msg_namelen = datagram.endpoint.capacity();
+      msg.msg_iov = reinterpret_cast<::iovec*>(&datagram.buffer);
+      msg.msg_iovlen = 1;
+#  if ICE_OS_LINUX && defined(UDP_GRO)
+      msg.msg_control = control[i].data();
+      msg.msg_controllen = control[i].size();
+#  endif
+    }
+    const auto rc = ::recvmmsg(handle, messages.data(), static_cast<unsigned>(size), 0, nullptr);
+    if (rc < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (count) {
+        break;
+      }
+      return -1;
+    }
+    for (std::size_t i = 0; i < static_cast<std::size_t>(rc); i++) {
+      auto& datagram = datagrams[count + i];
+      const auto& msg = messages[i].msg_hdr;
+      datagram.endpoint.size() = msg.msg_namelen;
+      datagram.size = messages[i].msg_len;
+      datagram.segment_size = 0;
+#  if ICE_OS_LINUX && defined(UDP_GRO)
+      for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(const_cast<::msghdr*>(&msg), cmsg)) {
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+          int segment_size = 0;
+          std::memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+          datagram.segment_size = static_cast<std::size_t>(segment_size);
+        }
+      }
+#  endif
+    }
+    count += static_cast<std::size_t>(rc);
+    if (static_cast<std::size_t>(rc) < size) {
+      break;
+    }
+  }
+  return static_cast<ssize_t>(count);
+}
+
+// Sends datagrams until all datagrams were sent or the socket would block.
+// Returns the number of sent datagrams or -1 with errno set when no datagram was sent.
+ssize_t send_datagrams(int handle, std::span<datagram> datagrams) noexcept
+{
+  std::array<::mmsghdr, batch_size> messages;
+  std::size_t count = 0;
+  while (count < datagrams.size()) {
+    const auto size = std::min(datagrams.size() - count, batch_size);
+    for (std::size_t i = 0; i < size; i++) {
+      auto& datagram = datagrams[count + i];
+      auto& msg = messages[i].msg_hdr;
+      msg = {};
+      msg.msg_name = &datagram.endpoint.sockaddr();
+      msg.msg_namelen = datagram.endpoint.size();
+      msg.msg_iov = reinterpret_cast<::iovec*>(&datagram.buffer);
+      msg.msg_iovlen = 1;
+    }
+    const auto rc = ::sendmmsg(handle, messages.data(), static_cast<unsigned>(size), 0);
+    if (rc < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (count) {
+        break;
+      }
+      return -1;
+    }
+    for (std::size_t i = 0; i < static_cast<std::size_t>(rc); i++) {
+      datagrams[count + i].size = messages[i].msg_len;
+    }
+    count += static_cast<std::size_t>(rc);
+    if (static_cast<std::size_t>(rc) < size) {
+      break;
+    }
+  }
+  return static_cast<ssize_t>(count);
+}
+
+#endif
+
+}  // namespace detail
+
+std::error_code socket::create(int family) noexcept
+{
+  return net::socket::create(family, SOCK_DGRAM, IPPROTO_UDP);
+}
+
+std::error_code socket::gro(bool enable) noexcept
+{
+#if ICE_OS_LINUX && defined(UDP_GRO)
+  const int value = enable ? 1 : 0;
+  return set(SOL_UDP, UDP_GRO, &value, sizeof(value));
+#else
+  return make_error_code(std::errc::operation_not_supported);
+#endif
+}
+
+#if ICE_OS_WIN32
+
+async<std::size_t> socket::recv_from(
+  char* data, std::size_t size, endpoint& endpoint, timer::time_point deadline, cancellation_token token,
+  std::error_code& ec) noexcept
+{
+  ec.clear();
+  const auto handle = handle_.as<HANDLE>();
+  const auto socket = handle_.as<SOCKET>();
+  WSABUF buffer = { static_cast<ULONG>(size), data };
+  DWORD bytes = 0;
+  DWORD flags = 0;
+  endpoint.size() = endpoint.capacity();
+  event ev{ *this, deadline, token };
+  if (::WSARecvFrom(socket, &buffer, 1, &bytes, &flags, &endpoint.sockaddr(), &endpoint.size(), &ev, nullptr) !=
+      SOCKET_ERROR) {
+    co_return bytes;
+  }
+  if (const auto rc = ::WSAGetLastError(); rc != ERROR_IO_PENDING) {
+    ec = make_error_code(rc);
+    co_return{};
+  }
+  co_await ev;
+  if (!::GetOverlappedResult(handle, &ev, &bytes, FALSE)) {
+    ec = ev.error(::WSAGetLastError());
+    co_return{};
+  }
+  co_return bytes;
+}
+
+async<std::size_t> socket::send_to(
+  const char* data, std::size_t size, const endpoint& endpoint, timer::time_point deadline,
+  cancellation_token token, std::error_code& ec) noexcept
+{
+  ec.clear();
+  const auto handle = handle_.as<HANDLE>();
+  const auto socket = handle_.as<SOCKET>();
+  WSABUF buffer = { static_cast<ULONG>(size), const_cast<char*>(data) };
+  DWORD bytes = 0;
+  event ev{ *this, deadline, token };
+  if (::WSASendTo(socket, &buffer, 1, &bytes, 0, &endpoint.sockaddr(), endpoint.size(), &ev, nullptr) !=
+      SOCKET_ERROR) {
+    co_return bytes;
+  }
+  if (const auto rc = ::WSAGetLastError(); rc != ERROR_IO_PENDING) {
+    ec = make_error_code(rc);
+    co_return{};
+  }
+  co_await ev;
+  if (!::GetOverlappedResult(handle, &ev, &bytes, FALSE)) {
+    ec = ev.error(::WSAGetLastError());
+    co_return{};
+  }
+  co_return bytes;
+}
+
+async<std::size_t> socket::recv_from(
+  std::span<datagram> datagrams, timer::time_point deadline, cancellation_token token, std::error_code& ec) noexcept
+{
+  ec.clear();
+  if (datagrams.empty()) {
+    co_return 0;
+  }
+  auto& datagram = datagrams.front();
+  const auto& buffer = datagram.buffer;
+  datagram.size = co_await recv_from(buffer.data, buffer.size, datagram.endpoint, deadline, token, ec);
+  datagram.segment_size = 0;
+  co_return ec ? 0 : 1;
+}
+
+async<std::size_t> socket::send_to(
+  std::span<datagram> datagrams, timer::time_point deadline, cancellation_token token, std::error_code& ec) noexcept
+{
+  ec.clear();
+  std::size_t count = 0;
+  for (auto& datagram : datagrams) {
+    const auto& buffer = datagram.buffer;
+    datagram.size = co_await send_to(buffer.data, buffer.size, datagram.endpoint, deadline, token, ec);
+    if (ec) {
+      break;
+    }
+    count++;
+  }
+  co_return count;
+}
+
+#else
+
+async<std::size_t> socket::recv_from(
+  char* data, std::size_t size, endpoint& endpoint, timer::time_point deadline, cancellation_token token,
+  std::error_code& ec) noexcept
+{
+  ec.clear();
+  while (true) {
+    endpoint.size() = endpoint.capacity();
+    if (const auto rc = ::recvfrom(handle(), data, size, 0, &endpoint.sockaddr(), &endpoint.size()); rc >= 0) {
+      co_return static_cast<std::size_t>(rc);
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (errno != EAGAIN) {
+      ec = make_error_code(errno);
+      break;
+    }
+    if (const auto rc = co_await event{ *this, ICE_EVENT_RECV, deadline, token }) {
+      ec = rc;
+      break;
+    }
+  }
+  co_return 0;
+}
+
+async<std::size_t> socket::send_to(
+  const char* data, std::size_t size, const endpoint& endpoint, timer::time_point deadline,
+  cancellation_token token, std::error_code& ec) noexcept
+{
+  ec.clear();
+  while (true) {
+    if (const auto rc = ::sendto(handle(), data, size, 0, &endpoint.sockaddr(), endpoint.size()); rc >= 0) {
+      co_return static_cast<std::size_t>(rc);
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (errno != EAGAIN) {
+      ec = make_error_code(errno);
+      break;
+    }
+    if (const auto rc = co_await event{ *this, ICE_EVENT_SEND, deadline, token }) {
+      ec = rc;
+      break;
+    }
+  }
+  co_return 0;
+}
+
+async<std::size_t> socket::recv_from(
+  std::span<datagram> datagrams, timer::time_point deadline, cancellation_token token, std::error_code& ec) noexcept
+{
+  ec.clear();
+  if (datagrams.empty()) {
+    co_return 0;
+  }
+  while (true) {
+    if (const auto rc = detail::recv_datagrams(handle(), datagrams); rc >= 0) {
+      co_return static_cast<std::size_t>(rc);
+    }
+    if (errno != EAGAIN) {
+      ec = make_error_code(errno);
+      break;
+    }
+    if (const auto rc = co_await event{ *this, ICE_EVENT_RECV, deadline, token }) {
+      ec = rc;
+      break;
+    }
+  }
+  co_return 0;
+}
+
+async<std::size_t> socket::send_to(
+  std::span<datagram> datagrams, timer::time_point deadline, cancellation_token token, std::error_code& ec) noexcept
+{
+  ec.clear();
+  std::size_t count = 0;
+  while (count < datagrams.size()) {
+    if (const auto rc = detail::send_datagrams(handle(), datagrams.subspan(count)); rc >= 0) {
+      count += static_cast<std::size_t>(rc);
+      continue;
+    }
+    if (errno != EAGAIN) {
+      ec = make_error_code(errno);
+      break;
+    }
+    if (const auto rc = co_await event{ *this, ICE_EVENT_SEND, deadline, token }) {
+      ec = rc;
+      break;
+    }
+  }
+  co_return count;
+}
+
+#endif
+
+async<std::size_t> socket::send_segments(
+  const char* data, std::size_t size, std::size_t segment_size, const endpoint& endpoint,
+  timer::time_point deadline, cancellation_token token, std::error_code& ec) noexcept
+{
+  ec.clear();
+  if (!segment_size || segment_size > size) {
+    segment_size = size;
+  }
+  std::size_t sent = 0;
+#if ICE_OS_LINUX && defined(UDP_SEGMENT)
+  // Single segments are sent without the control message. The kernel reports EIO when the device does not support
+  // checksum offload and EINVAL or ENOPROTOOPT when segmentation offload is not supported at all.
+  const auto segments = std::min(detail::gso_segments, std::max<std::size_t>(detail::gso_size / segment_size, 1));
+  while (segment_size < size && segment_size <= detail::gso_size && sent < size) {
+    const auto chunk = std::min(size - sent, segment_size * segments);
+    const auto rc = detail::send_segments(
+      handle(), data + sent, chunk, static_cast<std::uint16_t>(segment_size), endpoint);
+    if (rc >= 0) {
+      sent += static_cast<std::size_t>(rc);
+      continue;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT) {
+      break;
+    }
+    if (errno != EAGAIN) {
+      ec = make_error_code(errno);
+      co_return sent;
+    }
+    if (const auto rc = co_await event{ *this, ICE_EVENT_SEND, deadline, token }) {
+      ec = rc;
+      co_return sent;
+    }
+  }
+#endif
+  while (sent < size) {
+    const auto chunk = std::min(size - sent, segment_size);
+    const auto rv = co_await send_to(data + sent, chunk, endpoint, deadline, token, ec);
+    if (ec) {
+      break;
+    }
+    sent += rv;
+  }
+  co_return sent;
+}
+
+}  // namespace ice::net::udp
@@ -0,0 +1,304 @@
+#include "ice/net/uring.hpp"
+
+#if ICE_URING
+#  include <ice/error.hpp>
+#  include <algorithm>
+#  include <thread>
+#  include <cassert>
+#  include <cstring>
+
+#  include <sys/eventfd.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+
+namespace ice::net {
+
+bool uring::operation::await_suspend(std::coroutine_handle<> awaiter) noexcept
+{
+  awaiter_ = awaiter;
+  const auto uring = service_.uring();
+  if (!uring) {
+    result_ = -EOPNOTSUPP;
+    return false;
+  }
+  if (token_.is_cancellation_requested()) {
+    canceled_ = true;
+    result_ = -ECANCELED;
+    return false;
+  }
+  suspending_.store(true, std::memory_order_relaxed);
+  if (const auto ec = uring->queue(*this, !service_.is_current())) {
+    result_ = -ec.value();
+    return false;
+  }
+
+  // The completion waits until the deadline and the cancellation callback are set up and this function no longer
+  // accesses the operation.
+  arm();
+  if (!attach(token_)) {
+    cancel(*this);
+  }
+  suspending_.store(false, std::memory_order_release);
+  return true;
+}
+
+void uring::operation::resume(int result) noexcept
+{
+  while (suspending_.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+  disarm();
+  detach();
+  if (cancel_pending_.load(std::memory_order_relaxed)) {
+    service_.uring()->forget(*this);
+  }
+  if (result == -ECANCELED || result == -EINTR) {
+    if (expired_) {
+      result = -ETIMEDOUT;
+    } else if (canceled_) {
+      result = -ECANCELED;
+    }
+  }
+  result_ = result;
+  awaiter_.resume();
+}
+
+void uring::operation::expire(timer& timer) noexcept
+{
+  auto& operation = static_cast<uring::operation&>(static_cast<net::deadline&>(timer));
+  operation.expired_ = true;
+  const auto& service = operation.service_;
+  // A cancel request that does not fit into the submission queue is kept and submitted by the service loop.
+  service.uring()->cancel(operation, !service.is_current());
+  operation.done();
+}
+
+void uring::operation::cancel(cancellation_registration& registration) noexcept
+{
+  auto& operation = static_cast<uring::operation&>(registration);
+  operation.canceled_ = true;
+  const auto& service = operation.service_;
+  service.uring()->cancel(operation, !service.is_current());
+  operation.release();
+}
+
+uring::~uring()
+{
+  if (sqes_) {
+    ::munmap(sqes_, sqes_size_);
+  }
+  if (ring_) {
+    ::munmap(ring_, ring_size_);
+  }
+}
+
+std::error_code uring::create(unsigned entries) noexcept
+{
+  io_uring_params params = {};
+  handle_.reset(static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params)));
+  if (!handle_) {
+    return make_error_code(errno);
+  }
+
+  // Fast poll makes socket operations wait for readiness in the kernel instead of an io worker thread.
+  constexpr auto features = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_FAST_POLL;
+  if ((params.features & features) != features) {
+    return make_error_code(std::errc::not_supported);
+  }
+
+  const auto sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  const auto cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  ring_size_ = std::max<std::size_t>(sq_ring_size, cq_ring_size);
+  constexpr auto protection = PROT_READ | PROT_WRITE;
+  constexpr auto flags = MAP_SHARED | MAP_POPULATE;
+  const auto ring = ::mmap(nullptr, ring_size_, protection, flags, static_cast<int>(handle_), IORING_OFF_SQ_RING);
+  if (ring == MAP_FAILED) {
+    return make_error_code(errno);
+  }
+  ring_ = ring;
+
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  const auto sqes = ::mmap(nullptr, sqes_size_, protection, flags, static_cast<int>(handle_), IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    return make_error_code(errno);
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  const auto data = static_cast<char*>(ring_);
+  sq_head_ = reinterpret_cast<std::atomic<unsigned>*>(data + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<std::atomic<unsigned>*>(data + params.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<unsigned*>(data + params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+  const auto sq_array = reinterpret_cast<unsigned*>(data + params.sq_off.array);
+  for (unsigned i = 0; i < sq_entries_; i++) {
+    sq_array[i] = i;
+  }
+
+  cq_head_ = reinterpret_cast<std::atomic<unsigned>*>(data + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<std::atomic<unsigned>*>(data + params.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<unsigned*>(data + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(data + params.cq_off.cqes);
+
+  events_.reset(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+  if (!events_) {
+    return make_error_code(errno);
+  }
+  const int events = events_;
+  if (::syscall(__NR_io_uring_register, static_cast<int>(handle_), IORING_REGISTER_EVENTFD, &events, 1) < 0) {
+    return make_error_code(errno);
+  }
+  return {};
+}
+
+std::error_code uring::queue(operation& operation, bool submit) noexcept
+{
+  std::error_code ec;
+  std::unique_lock lock{ sq_mutex_ };
+  const auto sqe = acquire(lock, ec);
+  if (!sqe) {
+    return ec;
+  }
+  sqe->opcode = operation.opcode_;
+  sqe->fd = operation.handle_;
+  sqe->addr = reinterpret_cast<std::uint64_t>(operation.address);
+  sqe->off = operation.offset;
+  sqe->len = operation.size;
+  sqe->rw_flags = static_cast<decltype(sqe->rw_flags)>(operation.flags);
+  const auto address = reinterpret_cast<std::uint64_t>(&operation);
+  assert((address & ~key_mask) == 0);
+  operation.key_ = address | (++sequence_ << key_shift);
+  sqe->user_data = operation.key_;
+  sq_tail_->fetch_add(1, std::memory_order_release);
+  sq_queued_++;
+  if (submit) {
+    // The operation stays queued and is submitted by the service loop when this fails.
+    this->submit(lock);
+  }
+  return {};
+}
+
+std::error_code uring::cancel(operation& operation, bool submit) noexcept
+{
+  std::unique_lock lock{ sq_mutex_ };
+  if (const auto ec = queue_cancel(lock, operation)) {
+    // The service loop queues the request again before it waits for events, and a full submission queue means
+    // that completions are pending and wake it up.
+    if (!operation.cancel_pending_.load(std::memory_order_relaxed)) {
+      operation.cancel_pending_.store(true, std::memory_order_relaxed);
+      operation.cancel_next_ = std::exchange(cancels_, &operation);
+    }
+    return ec;
+  }
+  if (submit) {
+    this->submit(lock);
+  }
+  return {};
+}
+
+std::error_code uring::submit() noexcept
+{
+  std::unique_lock lock{ sq_mutex_ };
+  while (cancels_) {
+    if (queue_cancel(lock, *cancels_)) {
+      break;
+    }
+    cancels_->cancel_pending_.store(false, std::memory_order_relaxed);
+    cancels_ = std::exchange(cancels_->cancel_next_, nullptr);
+  }
+  return submit(lock);
+}
+
+void uring::process() noexcept
+{
+  // Resets the counter before the completions are reaped, so that every later completion signals the eventfd again
+  // and produces a new edge for the service event queue.
+  std::uint64_t value = 0;
+  while (::read(events_, &value, sizeof(value)) < 0 && errno == EINTR) {
+  }
+  while (true) {
+    std::unique_lock lock{ cq_mutex_ };
+    const auto head = cq_head_->load(std::memory_order_relaxed);
+    if (head == cq_tail_->load(std::memory_order_acquire)) {
+      break;
+    }
+    const auto& cqe = cqes_[head & cq_mask_];
+    const auto operation = reinterpret_cast<uring::operation*>(cqe.user_data & key_mask);
+    const auto result = cqe.res;
+    cq_head_->store(head + 1, std::memory_order_release);
+    lock.unlock();
+    if (operation) {
+      operation->resume(result);
+    }
+  }
+}
+
+io_uring_sqe* uring::acquire(std::unique_lock<std::mutex>& lock, std::error_code& ec) noexcept
+{
+  const auto tail = sq_tail_->load(std::memory_order_relaxed);
+  if (tail - sq_head_->load(std::memory_order_acquire) >= sq_entries_) {
+    if ((ec = submit(lock))) {
+      return nullptr;
+    }
+    if (tail - sq_head_->load(std::memory_order_acquire) >= sq_entries_) {
+      ec = make_error_code(std::errc::resource_unavailable_try_again);
+      return nullptr;
+    }
+  }
+  const auto sqe = &sqes_[tail & sq_mask_];
+  std::memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+std::error_code uring::queue_cancel(std::unique_lock<std::mutex>& lock, operation& operation) noexcept
+{
+  std::error_code ec;
+  const auto sqe = acquire(lock, ec);
+  if (!sqe) {
+    return ec;
+  }
+  // The completion of the cancel request has no operation and is ignored.
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = operation.key_;
+  sqe->user_data = 0;
+  sq_tail_->fetch_add(1, std::memory_order_release);
+  sq_queued_++;
+  return {};
+}
+
+// Removes an operation that completed before its cancel request could be queued.
+void uring::forget(operation& operation) noexcept
+{
+  std::lock_guard lock{ sq_mutex_ };
+  for (auto entry = &cancels_; *entry; entry = &(*entry)->cancel_next_) {
+    if (*entry == &operation) {
+      *entry = std::exchange(operation.cancel_next_, nullptr);
+      operation.cancel_pending_.store(false, std::memory_order_relaxed);
+      break;
+    }
+  }
+}
+
+std::error_code uring::submit(std::unique_lock<std::mutex>& lock) noexcept
+{
+  (void)lock;
+  while (sq_queued_ > 0) {
+    const auto rc = ::syscall(__NR_io_uring_enter, static_cast<int>(handle_), sq_queued_, 0, 0, nullptr, 0);
+    if (rc < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return make_error_code(errno);
+    }
+    if (rc == 0) {
+      break;
+    }
+    sq_queued_ -= static_cast<unsigned>(rc);
+  }
+  return {};
+}
+
+}  // namespace ice::net
+
+#endif
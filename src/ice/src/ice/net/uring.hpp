@@ -0,0 +1,163 @@
+#pragma once
+#include <ice/config.hpp>
+
+#if ICE_URING
+#  include <ice/cancellation.hpp>
+#  include <ice/error.hpp>
+#  include <ice/net/deadline.hpp>
+#  include <ice/net/service.hpp>
+#  include <ice/timer.hpp>
+#  include <linux/io_uring.h>
+#  include <atomic>
+#  include <coroutine>
+#  include <mutex>
+#  include <system_error>
+#  include <utility>
+#  include <cerrno>
+#  include <cstdint>
+
+namespace ice::net {
+
+// Completion based io_uring submission and completion queues.
+// Operations are queued by coroutines and submitted in one batch per service loop iteration. Completions are
+// signalled through an eventfd that is registered with the service event queue.
+class uring {
+public:
+  class operation final : private deadline, private cancellation_registration {
+  public:
+    // Cancels the operation when the deadline expires or cancellation is requested.
+    operation(
+      net::service& service, std::uint8_t opcode, int handle, timer::time_point deadline = timer::time_point::max(),
+      cancellation_token token = {}) noexcept :
+      net::deadline(&service, deadline, expire),
+      cancellation_registration(cancel), service_(service), token_(std::move(token)), opcode_(opcode), handle_(handle)
+    {}
+
+    operation(operation&& other) = delete;
+    operation(const operation& other) = delete;
+    operation& operator=(operation&& other) = delete;
+    operation& operator=(const operation& other) = delete;
+
+    ~operation() = default;
+
+    constexpr bool await_ready() const noexcept
+    {
+      return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiter) noexcept;
+
+    // Returns the number of bytes transferred, a new descriptor or a negative error code.
+    constexpr int await_resume() const noexcept
+    {
+      return result_;
+    }
+
+    // Returns the error code of a failed operation.
+    std::error_code error() const noexcept
+    {
+      if (expired_ && result_ == -ETIMEDOUT) {
+        return make_error_code(std::errc::timed_out);
+      }
+      if (canceled_ && result_ == -ECANCELED) {
+        return make_error_code(std::errc::operation_canceled);
+      }
+      return make_error_code(-result_);
+    }
+
+    void resume(int result) noexcept;
+
+    const void* address = nullptr;
+    std::uint64_t offset = 0;
+    std::uint32_t size = 0;
+    std::uint32_t flags = 0;
+
+  private:
+    friend class uring;
+
+    static void expire(timer& timer) noexcept;
+    static void cancel(cancellation_registration& registration) noexcept;
+
+    net::service& service_;
+    cancellation_token token_;
+    std::coroutine_handle<> awaiter_;
+    std::atomic_bool suspending_ = false;
+    std::uint8_t opcode_ = IORING_OP_NOP;
+    int handle_ = -1;
+    int result_ = 0;
+    std::uint64_t key_ = 0;
+    operation* cancel_next_ = nullptr;
+    std::atomic_bool cancel_pending_ = false;
+    bool expired_ = false;
+    bool canceled_ = false;
+  };
+
+  uring() noexcept = default;
+
+  uring(uring&& other) = delete;
+  uring(const uring& other) = delete;
+  uring& operator=(uring&& other) = delete;
+  uring& operator=(const uring& other) = delete;
+
+  ~uring();
+
+  std::error_code create(unsigned entries) noexcept;
+
+  // Queues the operation. Submits it immediately when the loop is not running on the current thread.
+  std::error_code queue(operation& operation, bool submit) noexcept;
+
+  // Queues a request to cancel the operation. When the submission queue is full, the request is kept and queued again
+  // before the next submission.
+  std::error_code cancel(operation& operation, bool submit) noexcept;
+
+  // Submits all queued operations and the cancel requests that did not fit into the submission queue.
+  std::error_code submit() noexcept;
+
+  // Resumes all completed operations.
+  void process() noexcept;
+
+  service::handle_view events() const noexcept
+  {
+    return events_;
+  }
+
+private:
+  io_uring_sqe* acquire(std::unique_lock<std::mutex>& lock, std::error_code& ec) noexcept;
+  std::error_code queue_cancel(std::unique_lock<std::mutex>& lock, operation& operation) noexcept;
+  void forget(operation& operation) noexcept;
+  std::error_code submit(std::unique_lock<std::mutex>& lock) noexcept;
+
+  // The user data of a request is the address of the operation with a sequence number in the upper bits that user
+  // space addresses do not use. A cancel request that is submitted after the operation completed and its coroutine
+  // frame was reused for another operation does not match the new request.
+  static constexpr unsigned key_shift = 48;
+  static constexpr std::uint64_t key_mask = (std::uint64_t(1) << key_shift) - 1;
+
+  service::handle_type handle_;
+  service::handle_type events_;
+
+  void* ring_ = nullptr;
+  std::size_t ring_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  std::size_t sqes_size_ = 0;
+
+  std::atomic<unsigned>* sq_head_ = nullptr;
+  std::atomic<unsigned>* sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  unsigned sq_queued_ = 0;
+  std::uint64_t sequence_ = 0;
+  operation* cancels_ = nullptr;
+
+  std::atomic<unsigned>* cq_head_ = nullptr;
+  std::atomic<unsigned>* cq_tail_ = nullptr;
+  io_uring_cqe* cqes_ = nullptr;
+  unsigned cq_mask_ = 0;
+
+  std::mutex sq_mutex_;
+  std::mutex cq_mutex_;
+};
+
+}  // namespace ice::net
+
+#endif
@@ -0,0 +1,116 @@
+#include "ice/synchronization.hpp"
+#include <mutex>
+
+namespace ice {
+
+bool async_semaphore::try_acquire() noexcept
+{
+  auto count = count_.load(std::memory_order_relaxed);
+  while (count) {
+    if (count_.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void async_semaphore::release(std::size_t count) noexcept
+{
+  auto value = count_.load(std::memory_order_relaxed);
+  while (true) {
+    const auto next = count < max_ - value ? value + count : max_;
+    if (count_.compare_exchange_weak(value, next, std::memory_order_release, std::memory_order_relaxed)) {
+      break;
+    }
+  }
+
+  // Pairs with the fence in suspend, so that either the waiter takes the permit or the waiter is found here.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!waiting_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  detail::async_waiter* head = nullptr;
+  detail::async_waiter* tail = nullptr;
+  std::unique_lock lock{ mutex_ };
+  while (head_ && try_acquire()) {
+    const auto waiter = head_;
+    head_ = waiter->next;
+    if (!head_) {
+      tail_ = nullptr;
+    }
+    waiter->next = nullptr;
+    if (tail) {
+      tail->next = waiter;
+    } else {
+      head = waiter;
+    }
+    tail = waiter;
+    waiting_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  lock.unlock();
+  detail::async_waiter::resume(head);
+}
+
+bool async_semaphore::suspend(detail::async_waiter& waiter) noexcept
+{
+  std::lock_guard lock{ mutex_ };
+  waiting_.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (try_acquire()) {
+    waiting_.fetch_sub(1, std::memory_order_relaxed);
+    return false;
+  }
+  waiter.next = nullptr;
+  if (tail_) {
+    tail_->next = &waiter;
+  } else {
+    head_ = &waiter;
+  }
+  tail_ = &waiter;
+  return true;
+}
+
+void async_manual_reset_event::set() noexcept
+{
+  const auto state = state_.exchange(this, std::memory_order_acq_rel);
+  if (state != this) {
+    detail::async_waiter::resume(static_cast<detail::async_waiter*>(state));
+  }
+}
+
+bool async_manual_reset_event::suspend(detail::async_waiter& waiter) noexcept
+{
+  auto state = state_.load(std::memory_order_acquire);
+  do {
+    if (state == this) {
+      return false;
+    }
+    waiter.next = static_cast<detail::async_waiter*>(state);
+  } while (!state_.compare_exchange_weak(state, &waiter, std::memory_order_release, std::memory_order_acquire));
+  return true;
+}
+
+bool async_barrier::suspend(detail::async_waiter& waiter) noexcept
+{
+  auto head = head_.load(std::memory_order_relaxed);
+  do {
+    waiter.next = head;
+  } while (!head_.compare_exchange_weak(head, &waiter, std::memory_order_release, std::memory_order_relaxed));
+  if (remaining_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return true;
+  }
+
+  // All participants of this phase are suspended, so none of them can arrive again before they are resumed.
+  head = head_.exchange(nullptr, std::memory_order_acquire);
+  remaining_.store(count_, std::memory_order_relaxed);
+  while (head) {
+    const auto next = head->next;
+    if (head != &waiter) {
+      head->resume();
+    }
+    head = next;
+  }
+  return false;
+}
+
+}  // namespace ice
@@ -0,0 +1,180 @@
+#include "ice/thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <utility>
+#include <cassert>
+
+namespace ice {
+
+thread_pool::~thread_pool()
+{
+  stop();
+  join();
+}
+
+std::error_code thread_pool::create(std::size_t size) noexcept
+{
+  assert(!workers_);
+  if (!size) {
+    size = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  workers_.reset(new (std::nothrow) worker[size]);
+  if (!workers_) {
+    return make_error_code(std::errc::not_enough_memory);
+  }
+  size_ = size;
+  for (std::size_t i = 0; i < size; i++) {
+    workers_[i].thread = std::thread([this, i]() noexcept { run(i); });
+  }
+  return {};
+}
+
+void thread_pool::join() noexcept
+{
+  for (std::size_t i = 0; i < size_; i++) {
+    if (workers_[i].thread.joinable()) {
+      workers_[i].thread.join();
+    }
+  }
+}
+
+void thread_pool::stop(bool stop) noexcept
+{
+  {
+    std::lock_guard lock{ mutex_ };
+    stop_.store(stop, std::memory_order_release);
+  }
+  cv_.notify_all();
+}
+
+void thread_pool::post(ice::schedule<thread_pool>* schedule) noexcept
+{
+  const auto worker = static_cast<thread_pool::worker*>(index_.get());
+  if (!worker || !worker->local.push(schedule)) {
+    scheduler::post(schedule);
+  }
+  notify();
+}
+
+void thread_pool::post(ice::timer* timer) noexcept
+{
+  scheduler::post(timer);
+  if (is_current()) {
+    return;
+  }
+  {
+    std::lock_guard lock{ mutex_ };
+    timers_changed_ = true;
+  }
+  cv_.notify_one();
+}
+
+bool thread_pool::queue::push(ice::schedule<thread_pool>* schedule) noexcept
+{
+  const auto tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) >= capacity) {
+    return false;
+  }
+  entries_[tail % capacity].store(schedule, std::memory_order_relaxed);
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+ice::schedule<thread_pool>* thread_pool::queue::pop() noexcept
+{
+  // The entry can be overwritten by the owner once another worker took it, in which case the exchange fails.
+  auto head = head_.load(std::memory_order_acquire);
+  while (head != tail_.load(std::memory_order_acquire)) {
+    const auto schedule = entries_[head % capacity].load(std::memory_order_relaxed);
+    if (head_.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      return schedule;
+    }
+  }
+  return nullptr;
+}
+
+void thread_pool::run(std::size_t index) noexcept
+{
+  const auto current = index_.set(&workers_[index]);
+  while (true) {
+    expire();
+    if (const auto schedule = acquire(index)) {
+      schedule->resume();
+      continue;
+    }
+
+    // Posts that happen after the sleeping counter is incremented take the lock before they notify and can not
+    // slip in between the check and the wait.
+    std::unique_lock lock{ mutex_ };
+    sleeping_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto wake = [this]() {
+      return ready() || stop_.load(std::memory_order_acquire) || std::exchange(timers_changed_, false);
+    };
+    if (const auto timeout = scheduler::timeout(); timeout < 0) {
+      cv_.wait(lock, wake);
+    } else {
+      cv_.wait_for(lock, std::chrono::milliseconds(timeout), wake);
+    }
+    sleeping_.fetch_sub(1, std::memory_order_relaxed);
+    if (stop_.load(std::memory_order_acquire) && !ready()) {
+      return;
+    }
+  }
+}
+
+ice::schedule<thread_pool>* thread_pool::acquire(std::size_t index) noexcept
+{
+  auto& local = workers_[index].local;
+  if (const auto schedule = local.pop()) {
+    return schedule;
+  }
+
+  // Takes the whole shared queue, keeps the first coroutine and moves the rest to the local queue where other
+  // workers can steal it.
+  if (const auto head = scheduler::acquire()) {
+    auto next = head->next.load(std::memory_order_relaxed);
+    if (next) {
+      do {
+        const auto schedule = std::exchange(next, next->next.load(std::memory_order_relaxed));
+        if (!local.push(schedule)) {
+          scheduler::post(schedule);
+        }
+      } while (next);
+      notify();
+    }
+    return head;
+  }
+
+  for (std::size_t i = 1; i < size_; i++) {
+    if (const auto schedule = workers_[(index + i) % size_].local.pop()) {
+      return schedule;
+    }
+  }
+  return nullptr;
+}
+
+bool thread_pool::ready() const noexcept
+{
+  if (!empty()) {
+    return true;
+  }
+  for (std::size_t i = 0; i < size_; i++) {
+    if (!workers_[i].local.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void thread_pool::notify() noexcept
+{
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_relaxed)) {
+    { std::lock_guard lock{ mutex_ }; }
+    cv_.notify_one();
+  }
+}
+
+}  // namespace ice
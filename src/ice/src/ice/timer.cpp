@@ -0,0 +1,154 @@
+#include "ice/timer.hpp"
+#include <bit>
+
+namespace ice {
+namespace {
+
+constexpr auto tick_limit = std::chrono::duration_cast<std::chrono::milliseconds>(timer::duration::max()).count();
+
+// Rounds up so that timers never expire early.
+std::uint64_t expiry_tick(timer::time_point expiry) noexcept
+{
+  const auto ticks = std::chrono::ceil<std::chrono::milliseconds>(expiry.time_since_epoch()).count();
+  return ticks > 0 ? static_cast<std::uint64_t>(ticks) : 0;
+}
+
+std::uint64_t current_tick(timer::time_point now) noexcept
+{
+  const auto ticks = std::chrono::floor<std::chrono::milliseconds>(now.time_since_epoch()).count();
+  return ticks > 0 ? static_cast<std::uint64_t>(ticks) : 0;
+}
+
+timer::time_point to_time_point(std::uint64_t tick) noexcept
+{
+  if (tick >= static_cast<std::uint64_t>(tick_limit)) {
+    return timer::time_point::max();
+  }
+  return timer::time_point(std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(tick)));
+}
+
+}  // namespace
+
+timer_wheel::timer_wheel() noexcept : tick_(current_tick(timer::clock::now())) {}
+
+void timer_wheel::insert(timer& timer) noexcept
+{
+  timer.tick_ = expiry_tick(timer.expiry_);
+  link(timer, slot(timer.tick_));
+  size_++;
+}
+
+bool timer_wheel::remove(timer& timer) noexcept
+{
+  if (!timer.link_) {
+    return false;
+  }
+  *timer.link_ = timer.next_;
+  if (timer.next_) {
+    timer.next_->link_ = timer.link_;
+  }
+  if (timer.slot_ != expired && !heads_[timer.slot_]) {
+    bitmaps_[timer.slot_ / slots] &= ~(std::uint64_t(1) << (timer.slot_ % slots));
+  }
+  timer.next_ = nullptr;
+  timer.link_ = nullptr;
+  size_--;
+  return true;
+}
+
+timer* timer_wheel::advance(timer::time_point now) noexcept
+{
+  const auto tick = current_tick(now);
+  std::size_t level = 0;
+  std::size_t index = 0;
+  std::uint64_t event = 0;
+  while (find(level, index, event) && event <= tick) {
+    // Lower levels are empty, so only the slot that the new tick points to needs to be cascaded.
+    tick_ = event;
+    const auto slot = static_cast<std::uint16_t>(level * slots + index);
+    auto head = heads_[slot];
+    heads_[slot] = nullptr;
+    bitmaps_[level] &= ~(std::uint64_t(1) << index);
+    while (head) {
+      const auto next = head->next_;
+      link(*head, this->slot(head->tick_));
+      head = next;
+    }
+  }
+  if (tick_ < tick) {
+    tick_ = tick;
+  }
+
+  // Reverse the expired list, so that timers are returned in the order in which they expired.
+  timer* head = nullptr;
+  auto entry = heads_[expired];
+  heads_[expired] = nullptr;
+  while (entry) {
+    const auto next = entry->next_;
+    entry->next_ = head;
+    entry->link_ = nullptr;
+    head = entry;
+    entry = next;
+    size_--;
+  }
+  return head;
+}
+
+timer::time_point timer_wheel::deadline() const noexcept
+{
+  if (heads_[expired]) {
+    return to_time_point(tick_);
+  }
+  std::size_t level = 0;
+  std::size_t index = 0;
+  std::uint64_t event = 0;
+  if (find(level, index, event)) {
+    return to_time_point(event);
+  }
+  return timer::time_point::max();
+}
+
+std::uint16_t timer_wheel::slot(std::uint64_t tick) const noexcept
+{
+  if (tick <= tick_) {
+    return expired;
+  }
+  const auto level = static_cast<std::size_t>(std::bit_width(tick ^ tick_) - 1) / bits;
+  const auto index = static_cast<std::size_t>(tick >> (level * bits)) & (slots - 1);
+  return static_cast<std::uint16_t>(level * slots + index);
+}
+
+void timer_wheel::link(timer& timer, std::uint16_t slot) noexcept
+{
+  auto& head = heads_[slot];
+  timer.slot_ = slot;
+  timer.next_ = head;
+  timer.link_ = &head;
+  if (head) {
+    head->link_ = &timer.next_;
+  }
+  head = &timer;
+  if (slot != expired) {
+    bitmaps_[slot / slots] |= std::uint64_t(1) << (slot % slots);
+  }
+}
+
+bool timer_wheel::find(std::size_t& level, std::size_t& index, std::uint64_t& tick) const noexcept
+{
+  // Slots on a level are only occupied after the digit of the current tick on that level, and every event on a
+  // lower level happens before any event on a higher level.
+  for (level = 0; level < levels; level++) {
+    const auto shift = level * bits;
+    const auto digit = static_cast<std::size_t>(tick_ >> shift) & (slots - 1);
+    const auto mask = digit + 1 < slots ? bitmaps_[level] & (~std::uint64_t(0) << (digit + 1)) : 0;
+    if (mask) {
+      index = static_cast<std::size_t>(std::countr_zero(mask));
+      const auto high = shift + bits < 64 ? tick_ >> (shift + bits) << (shift + bits) : 0;
+      tick = high | (static_cast<std::uint64_t>(index) << shift);
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace ice
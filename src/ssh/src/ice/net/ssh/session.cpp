@@ -247,8 +247,8 @@ async<std::error_code> session::io() noexcept
   ready_ = true;
 #else
   switch (operation_) {
-  case operation::recv: ec = co_await event{ service(), socket_.handle(), ICE_EVENT_RECV }; break;
-  case operation::send: ec = co_await event{ service(), socket_.handle(), ICE_EVENT_RECV }; break;
+  case operation::recv: ec = co_await event{ socket_, ICE_EVENT_RECV }; break;
+  case operation::send: ec = co_await event{ socket_, ICE_EVENT_RECV }; break;
   default: ec = make_error_code(std::errc::invalid_argument); break;
   }
 #endif
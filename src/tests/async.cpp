@@ -0,0 +1,103 @@
+#include <ice/async.hpp>
+#include <ice/context.hpp>
+#include <ice/synchronization.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstddef>
+
+namespace {
+
+ice::async<std::size_t> depth(std::size_t size)
+{
+  if (!size) {
+    co_return 0;
+  }
+  co_return co_await depth(size - 1) + 1;
+}
+
+}  // namespace
+
+// Verifies that long chains of synchronously completing tasks run in constant stack space.
+// Compilers do not guarantee the tail call for symmetric transfer in unoptimized builds.
+TEST(async, symmetric_transfer)
+{
+#if ICE_DEBUG
+  constexpr std::size_t size = 1000;
+#else
+  constexpr std::size_t size = 1000000;
+#endif
+  std::size_t result = 0;
+  const auto task = [&]() -> ice::task {
+    result = co_await depth(size);
+  };
+  task();
+  EXPECT_EQ(result, size);
+}
+
+// Verifies that unlock posts waiters to their scheduler and resumes a batch of waiters inline on that scheduler.
+TEST(async, mutex_post)
+{
+  ice::context context;
+  ice::async_mutex mutex{ 2 };
+  std::vector<int> order;
+
+  const auto task = [&](int index) -> ice::task {
+    co_await mutex.lock_async(context);
+    EXPECT_TRUE(context.is_current());
+    order.push_back(index);
+    mutex.unlock();
+    order.push_back(-index);
+    if (index == 4) {
+      context.stop();
+    }
+  };
+
+  EXPECT_TRUE(mutex.try_lock());
+  for (auto i = 1; i <= 4; i++) {
+    task(i);
+  }
+  mutex.unlock();
+  EXPECT_TRUE(order.empty());
+
+  context.run();
+  EXPECT_EQ(order, (std::vector<int>{ 1, 2, 3, -3, -2, -1, 4, -4 }));
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
+
+// Verifies that readers share the mutex and that a writer waits for the readers and blocks new readers.
+TEST(async, shared_mutex)
+{
+  ice::async_shared_mutex mutex;
+  ice::async_manual_reset_event release;
+  int readers = 0;
+  int writers = 0;
+
+  const auto read = [&]() -> ice::task {
+    const auto lock = co_await mutex.scoped_lock_shared_async();
+    EXPECT_EQ(writers, 0);
+    readers++;
+    co_await release.wait();
+    readers--;
+  };
+  const auto write = [&]() -> ice::task {
+    const auto lock = co_await mutex.scoped_lock_async();
+    EXPECT_EQ(readers, 0);
+    EXPECT_EQ(writers, 0);
+    writers++;
+    co_await release.wait();
+    writers--;
+  };
+
+  read();
+  read();
+  EXPECT_EQ(readers, 2);
+  write();
+  EXPECT_EQ(writers, 0);
+  read();
+  EXPECT_EQ(readers, 2);
+
+  release.set();
+  EXPECT_EQ(readers, 0);
+  EXPECT_EQ(writers, 0);
+}
@@ -0,0 +1,92 @@
+#include <ice/async.hpp>
+#include <ice/channel.hpp>
+#include <ice/context.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+// Verifies that values sent by coroutines on one context are received once by coroutines on another context and
+// that waiters are resumed on their own context.
+TEST(channel, send_recv)
+{
+  constexpr int producers = 4;
+  constexpr int consumers = 3;
+  constexpr int count = 1000;
+
+  ice::context c0;
+  ice::context c1;
+  auto t0 = std::thread([&]() { c0.run(); });
+  auto t1 = std::thread([&]() { c1.run(); });
+
+  ice::channel<int, 8> channel;
+  std::atomic_int sending = producers;
+  std::atomic_int receiving = consumers;
+  std::atomic_int received = 0;
+  std::atomic_llong sum = 0;
+
+  const auto produce = [&](int index) -> ice::task {
+    co_await c0.schedule(true);
+    for (auto i = 0; i < count; i++) {
+      EXPECT_TRUE(co_await channel.send(index * count + i, c0));
+      EXPECT_TRUE(c0.is_current());
+    }
+    if (sending.fetch_sub(1) == 1) {
+      channel.close();
+    }
+  };
+
+  const auto consume = [&]() -> ice::task {
+    co_await c1.schedule(true);
+    while (const auto value = co_await channel.recv(c1)) {
+      EXPECT_TRUE(c1.is_current());
+      sum.fetch_add(*value);
+      received.fetch_add(1);
+    }
+    EXPECT_TRUE(c1.is_current());
+    if (receiving.fetch_sub(1) == 1) {
+      c0.stop();
+      c1.stop();
+    }
+  };
+
+  for (auto i = 0; i < consumers; i++) {
+    consume();
+  }
+  for (auto i = 0; i < producers; i++) {
+    produce(i);
+  }
+
+  t0.join();
+  t1.join();
+
+  constexpr long long total = producers * count;
+  EXPECT_EQ(received.load(), total);
+  EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+  EXPECT_TRUE(channel.closed());
+}
+
+// Verifies that senders fail after the channel was closed and that remaining values can still be received.
+TEST(channel, close)
+{
+  ice::context c0;
+  auto t0 = std::thread([&]() { c0.run(); });
+
+  ice::channel<std::unique_ptr<int>, 2> channel;
+  const auto task = [&]() -> ice::task {
+    co_await c0.schedule(true);
+    EXPECT_TRUE(co_await channel.send(std::make_unique<int>(1), c0));
+    EXPECT_TRUE(co_await channel.send(std::make_unique<int>(2), c0));
+    channel.close();
+    EXPECT_FALSE(co_await channel.send(std::make_unique<int>(3), c0));
+    const auto v1 = co_await channel.recv(c0);
+    EXPECT_TRUE(v1 && *v1 && **v1 == 1);
+    const auto v2 = co_await channel.recv(c0);
+    EXPECT_TRUE(v2 && *v2 && **v2 == 2);
+    EXPECT_FALSE(co_await channel.recv(c0));
+    c0.stop();
+  };
+  task();
+
+  t0.join();
+}
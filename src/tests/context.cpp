@@ -1,6 +1,8 @@
 #include <ice/async.hpp>
 #include <ice/context.hpp>
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
 #include <thread>
 
 // Verifies that the schedule operation works.
@@ -45,3 +47,31 @@ TEST(context, schedule)
   t0.join();
   t1.join();
 }
+
+// Verifies that timers resume on the context thread in expiry order.
+TEST(context, schedule_after)
+{
+  static ice::context c0;
+
+  auto t0 = std::thread([&]() { c0.run(); });
+
+  std::atomic_int order = 0;
+  const auto start = ice::timer::clock::now();
+  const auto after = [&]() -> ice::task {
+    co_await c0.schedule_after(std::chrono::milliseconds(20));
+    EXPECT_EQ(std::this_thread::get_id(), t0.get_id());
+    EXPECT_GE(ice::timer::clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_EQ(order.fetch_add(1), 1);
+    c0.stop();
+  };
+  const auto at = [&]() -> ice::task {
+    co_await c0.schedule_at(start + std::chrono::milliseconds(10));
+    EXPECT_EQ(std::this_thread::get_id(), t0.get_id());
+    EXPECT_EQ(order.fetch_add(1), 0);
+  };
+  after();
+  at();
+
+  t0.join();
+  EXPECT_EQ(order.load(), 2);
+}
@@ -0,0 +1,77 @@
+#include <ice/async.hpp>
+#include <ice/frame.hpp>
+#include <gtest/gtest.h>
+#include <coroutine>
+#include <cstdint>
+
+namespace {
+
+class object {
+public:
+  ice::frame_arena* arena() const noexcept
+  {
+    return arena_;
+  }
+
+  void arena(ice::frame_arena* arena) noexcept
+  {
+    arena_ = arena;
+  }
+
+  // Returns the address of a variable in the coroutine frame.
+  ice::async<std::uintptr_t> address() const
+  {
+    char local = 0;
+    co_await std::suspend_never{};
+    co_return reinterpret_cast<std::uintptr_t>(&local);
+  }
+
+private:
+  ice::frame_arena* arena_ = nullptr;
+};
+
+std::uintptr_t address(const object& object)
+{
+  std::uintptr_t address = 0;
+  const auto task = [&]() -> ice::task {
+    address = co_await object.address();
+  };
+  task();
+  return address;
+}
+
+}  // namespace
+
+// Verifies that freed frames are reused by the thread local pool.
+TEST(frame, pool)
+{
+  const auto frame = ice::allocate_frame(200, nullptr);
+  ice::deallocate_frame(frame, 200);
+  EXPECT_EQ(ice::allocate_frame(200, nullptr), frame);
+  ice::deallocate_frame(frame, 200);
+
+  const auto large = ice::allocate_frame(64 * 1024, nullptr);
+  EXPECT_TRUE(large);
+  ice::deallocate_frame(large, 64 * 1024);
+
+  object o;
+  const auto a = address(o);
+  EXPECT_NE(a, 0);
+  EXPECT_EQ(address(o), a);
+}
+
+// Verifies that member coroutines of objects with an arena allocate frames from the arena.
+TEST(frame, arena)
+{
+  object o;
+  const auto a = address(o);
+
+  ice::frame_arena arena;
+  o.arena(&arena);
+  const auto b = address(o);
+  EXPECT_NE(b, a);
+  EXPECT_EQ(address(o), b);
+
+  o.arena(nullptr);
+  EXPECT_EQ(address(o), a);
+}
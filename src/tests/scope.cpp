@@ -0,0 +1,69 @@
+#include <ice/async.hpp>
+#include <ice/scope.hpp>
+#include <ice/synchronization.hpp>
+#include <ice/thread_pool.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+
+// Verifies that join completes once all spawned work finished and that the scope can be reused.
+TEST(scope, join)
+{
+  ice::async_scope scope;
+  ice::async_manual_reset_event event;
+  int done = 0;
+  bool joined = false;
+
+  const auto work = [&]() -> ice::async<void> {
+    co_await event.wait();
+    done++;
+  };
+  const auto join = [&]() -> ice::task {
+    co_await scope.join();
+    joined = true;
+  };
+
+  scope.spawn(work());
+  scope.spawn(work());
+  EXPECT_EQ(scope.size(), 2);
+  join();
+  EXPECT_FALSE(joined);
+  event.set();
+  EXPECT_EQ(done, 2);
+  EXPECT_TRUE(joined);
+  EXPECT_EQ(scope.size(), 0);
+
+  joined = false;
+  scope.spawn(work());
+  EXPECT_EQ(done, 3);
+  join();
+  EXPECT_TRUE(joined);
+}
+
+// Verifies that join waits for work that completes on other threads.
+TEST(scope, thread_pool)
+{
+  constexpr int count = 1000;
+
+  ice::thread_pool pool;
+  EXPECT_FALSE(pool.create(4));
+
+  ice::async_scope scope;
+  std::atomic_int done = 0;
+
+  const auto work = [&]() -> ice::async<void> {
+    co_await pool.schedule(true);
+    done.fetch_add(1, std::memory_order_relaxed);
+  };
+  const auto task = [&]() -> ice::task {
+    for (auto i = 0; i < count; i++) {
+      scope.spawn(work());
+    }
+    co_await scope.join();
+    EXPECT_EQ(done.load(std::memory_order_relaxed), count);
+    pool.stop();
+  };
+  task();
+
+  pool.join();
+  EXPECT_EQ(done.load(), count);
+}
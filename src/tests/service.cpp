@@ -1,7 +1,11 @@
 #include <ice/async.hpp>
+#include <ice/cancellation.hpp>
 #include <ice/net/service.hpp>
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
 #include <thread>
+#include <vector>
 
 // Verifies that the schedule operation works.
 TEST(service, schedule)
@@ -47,3 +51,94 @@ TEST(service, schedule)
   t0.join();
   t1.join();
 }
+
+// Verifies that timers resume on the service thread in expiry order.
+TEST(service, schedule_after)
+{
+  static ice::net::service c0;
+  EXPECT_FALSE(c0.create());
+
+  auto t0 = std::thread([&]() { c0.run(); });
+
+  std::atomic_int order = 0;
+  const auto start = ice::timer::clock::now();
+  const auto after = [&]() -> ice::task {
+    co_await c0.schedule_after(std::chrono::milliseconds(20));
+    EXPECT_EQ(std::this_thread::get_id(), t0.get_id());
+    EXPECT_GE(ice::timer::clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_EQ(order.fetch_add(1), 1);
+    c0.stop();
+  };
+  const auto at = [&]() -> ice::task {
+    co_await c0.schedule_at(start + std::chrono::milliseconds(10));
+    EXPECT_EQ(std::this_thread::get_id(), t0.get_id());
+    EXPECT_EQ(order.fetch_add(1), 0);
+  };
+  after();
+  at();
+
+  t0.join();
+  EXPECT_EQ(order.load(), 2);
+}
+
+// Verifies that a canceled timer resumes on the service thread before it expires.
+TEST(service, schedule_after_cancel)
+{
+  static ice::net::service c0;
+  EXPECT_FALSE(c0.create());
+
+  auto t0 = std::thread([&]() { c0.run(); });
+
+  ice::cancellation_source cs;
+  const auto start = ice::timer::clock::now();
+  const auto wait = [&]() -> ice::task {
+    EXPECT_EQ(co_await c0.schedule_after(std::chrono::seconds(10), cs.token()), std::errc::operation_canceled);
+    EXPECT_EQ(std::this_thread::get_id(), t0.get_id());
+    EXPECT_LT(ice::timer::clock::now() - start, std::chrono::seconds(10));
+    EXPECT_EQ(co_await c0.schedule_after(std::chrono::seconds(10), cs.token()), std::errc::operation_canceled);
+    c0.stop();
+  };
+  wait();
+  cs.request_cancellation();
+
+  t0.join();
+}
+
+// Verifies that every coroutine is resumed exactly once when multiple threads run the service.
+TEST(service, run_threads)
+{
+  constexpr std::size_t count = 4;
+  constexpr std::size_t tasks = 10000;
+
+  static ice::net::service c0;
+  EXPECT_FALSE(c0.create());
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < count; i++) {
+    threads.emplace_back([&]() { EXPECT_FALSE(c0.run()); });
+  }
+
+  std::atomic_size_t resumed = 0;
+  std::atomic_size_t foreign = 0;
+  const auto task = [&]() -> ice::task {
+    co_await c0.schedule(true);
+    if (!c0.is_current()) {
+      foreign.fetch_add(1, std::memory_order_relaxed);
+    }
+    co_await c0.schedule(true);
+    resumed.fetch_add(1, std::memory_order_release);
+  };
+  for (std::size_t i = 0; i < tasks; i++) {
+    task();
+  }
+  while (resumed.load(std::memory_order_acquire) < tasks) {
+    std::this_thread::yield();
+  }
+  c0.stop();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(resumed.load(), tasks);
+  EXPECT_EQ(foreign.load(), 0);
+}
@@ -0,0 +1,658 @@
+#include <ice/async.hpp>
+#include <ice/cancellation.hpp>
+#include <ice/net/service.hpp>
+#include <ice/net/tcp/socket.hpp>
+#include <ice/synchronization.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cstdio>
+
+#if ICE_OS_WIN32
+#  include <io.h>
+#endif
+
+namespace {
+
+// Creates the service and checks that it uses io_uring exactly when requested.
+// Returns false when io_uring was requested, but is not supported by the kernel.
+bool create_service(ice::net::service& service, bool uring)
+{
+  EXPECT_FALSE(service.create(uring));
+#if ICE_URING
+  if (uring && !service.uring()) {
+    return false;
+  }
+  EXPECT_EQ(service.uring() != nullptr, uring);
+#endif
+  return true;
+}
+
+// Runs the test on a service thread with a connected pair of sockets and stops the service when it completed.
+// The function is called with the listening socket, the client socket and the accepted server side socket.
+template <typename Function>
+void run(Function function)
+{
+  ice::net::service c0;
+  EXPECT_FALSE(c0.create());
+
+  auto t0 = std::thread([&]() { c0.run(); });
+
+  ice::net::tcp::socket server{ c0 };
+  ice::net::tcp::socket client{ c0 };
+
+  [&]() -> ice::task {
+    co_await c0.schedule(true);
+    const auto ose = ice::on_scope_exit([&]() { c0.stop(); });
+
+    ice::net::endpoint ep;
+    EXPECT_FALSE(ep.create("127.0.0.1", 0));
+    EXPECT_FALSE(server.create(ep.family()));
+    EXPECT_FALSE(server.bind(ep));
+    EXPECT_FALSE(server.listen());
+    ep = server.name();
+
+    EXPECT_FALSE(client.create(ep.family()));
+    EXPECT_FALSE(co_await client.connect(ep));
+    ice::net::endpoint remote;
+    auto socket = co_await server.accept(remote);
+    EXPECT_TRUE(socket);
+
+    co_await function(server, client, socket);
+    client.close();
+  }();
+
+  t0.join();
+  server.close();
+}
+
+// Receives until the buffer is full or the connection is closed and sets the event.
+ice::task recv(ice::net::tcp::socket& socket, std::vector<char>& data, ice::async_manual_reset_event& done)
+{
+  std::error_code ec;
+  std::size_t size = 0;
+  while (size < data.size()) {
+    const auto rv = co_await socket.recv(data.data() + size, data.size() - size, ec);
+    if (ec || !rv) {
+      break;
+    }
+    size += rv;
+  }
+  EXPECT_FALSE(ec);
+  EXPECT_EQ(size, data.size());
+  done.set();
+}
+
+void echo(bool uring)
+{
+  ice::net::service c0;
+  if (!create_service(c0, uring)) {
+    GTEST_SKIP() << "io_uring is not supported";
+  }
+
+  auto t0 = std::thread([&]() { c0.run(); });
+
+  ice::net::tcp::socket server{ c0 };
+  ice::net::tcp::socket client{ c0 };
+
+  [&]() -> ice::task {
+    co_await c0.schedule(true);
+    const auto ose = ice::on_scope_exit([&]() { c0.stop(); });
+
+    ice::net::endpoint ep;
+    EXPECT_FALSE(ep.create("127.0.0.1", 0));
+    EXPECT_FALSE(server.create(ep.family()));
+    EXPECT_FALSE(server.bind(ep));
+    EXPECT_FALSE(server.listen());
+    ep = server.name();
+
+    [&]() -> ice::task {
+      ice::net::endpoint remote;
+      auto socket = co_await server.accept(remote);
+      EXPECT_TRUE(socket);
+      std::array<char, 64> buffer;
+      std::error_code ec;
+      while (true) {
+        const auto size = co_await socket.recv(buffer.data(), buffer.size(), ec);
+        if (ec || !size) {
+          break;
+        }
+        EXPECT_EQ(co_await socket.send(buffer.data(), size, ec), size);
+      }
+      EXPECT_FALSE(ec);
+    }();
+
+    EXPECT_FALSE(client.create(ep.family()));
+    EXPECT_FALSE(co_await client.connect(ep));
+
+    std::array<char, 64> buffer;
+    std::error_code ec;
+    for (auto i = 0; i < 100; i++) {
+      const auto c = static_cast<char>('0' + i % 10);
+      EXPECT_EQ(co_await client.send(&c, 1, ec), 1);
+      EXPECT_EQ(co_await client.recv(buffer.data(), buffer.size(), ec), 1);
+      EXPECT_EQ(buffer[0], c);
+    }
+    EXPECT_FALSE(ec);
+    client.close();
+  }();
+
+  t0.join();
+  server.close();
+}
+
+void echo_threads(bool uring)
+{
+  constexpr std::size_t count = 4;
+  constexpr std::size_t connections = 8;
+
+  ice::net::service c0;
+  if (!create_service(c0, uring)) {
+    GTEST_SKIP() << "io_uring is not supported";
+  }
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < count; i++) {
+    threads.emplace_back([&]() { c0.run(); });
+  }
+
+  ice::net::tcp::socket server{ c0 };
+  ice::net::endpoint ep;
+  EXPECT_FALSE(ep.create("127.0.0.1", 0));
+  EXPECT_FALSE(server.create(ep.family()));
+  EXPECT_FALSE(server.bind(ep));
+  EXPECT_FALSE(server.listen());
+  ep = server.name();
+
+  // The coroutines outlive the statement that starts them and must not refer to temporary lambda objects.
+  std::atomic_size_t done = 0;
+  const auto serve = [&](ice::net::tcp::socket socket) -> ice::task {
+    std::array<char, 64> buffer;
+    std::error_code ec;
+    while (true) {
+      const auto size = co_await socket.recv(buffer.data(), buffer.size(), ec);
+      if (ec || !size) {
+        break;
+      }
+      EXPECT_EQ(co_await socket.send(buffer.data(), size, ec), size);
+    }
+    EXPECT_FALSE(ec);
+    done.fetch_add(1, std::memory_order_release);
+  };
+
+  const auto accept = [&]() -> ice::task {
+    co_await c0.schedule(true);
+    for (std::size_t i = 0; i < connections; i++) {
+      ice::net::endpoint remote;
+      auto socket = co_await server.accept(remote);
+      EXPECT_TRUE(socket);
+      serve(std::move(socket));
+    }
+  };
+
+  const auto connect = [&]() -> ice::task {
+    co_await c0.schedule(true);
+    ice::net::tcp::socket client{ c0 };
+    EXPECT_FALSE(client.create(ep.family()));
+    EXPECT_FALSE(co_await client.connect(ep));
+    std::array<char, 64> buffer;
+    std::error_code ec;
+    for (auto i = 0; i < 100; i++) {
+      const auto c = static_cast<char>('0' + i % 10);
+      EXPECT_EQ(co_await client.send(&c, 1, ec), 1);
+      EXPECT_EQ(co_await client.recv(buffer.data(), buffer.size(), ec), 1);
+      EXPECT_EQ(buffer[0], c);
+      EXPECT_TRUE(c0.is_current());
+    }
+    EXPECT_FALSE(ec);
+    client.close();
+    done.fetch_add(1, std::memory_order_release);
+  };
+
+  accept();
+  for (std::size_t i = 0; i < connections; i++) {
+    connect();
+  }
+
+  while (done.load(std::memory_order_acquire) < connections * 2) {
+    std::this_thread::yield();
+  }
+  c0.stop();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  server.close();
+}
+
+void timeout(bool uring)
+{
+  ice::net::service c0;
+  if (!create_service(c0, uring)) {
+    GTEST_SKIP() << "io_uring is not supported";
+  }
+
+  auto t0 = std::thread([&]() { c0.run(); });
+
+  ice::net::tcp::socket server{ c0 };
+  ice::net::tcp::socket client{ c0 };
+
+  [&]() -> ice::task {
+    co_await c0.schedule(true);
+    const auto ose = ice::on_scope_exit([&]() { c0.stop(); });
+
+    ice::net::endpoint ep;
+    EXPECT_FALSE(ep.create("127.0.0.1", 0));
+    EXPECT_FALSE(server.create(ep.family()));
+    EXPECT_FALSE(server.bind(ep));
+    EXPECT_FALSE(server.listen());
+    ep = server.name();
+
+    const auto deadline = [](int ms) { return ice::timer::clock::now() + std::chrono::milliseconds(ms); };
+
+    ice::net::endpoint remote;
+    auto start = ice::timer::clock::now();
+    EXPECT_FALSE(co_await server.accept(remote, deadline(20)));
+    EXPECT_GE(ice::timer::clock::now() - start, std::chrono::milliseconds(20));
+
+    EXPECT_FALSE(client.create(ep.family()));
+    EXPECT_FALSE(co_await client.connect(ep, deadline(1000)));
+    auto socket = co_await server.accept(remote, deadline(1000));
+    EXPECT_TRUE(socket);
+
+    std::array<char, 64> buffer;
+    std::error_code ec;
+    start = ice::timer::clock::now();
+    EXPECT_EQ(co_await client.recv(buffer.data(), buffer.size(), deadline(20), ec), 0);
+    EXPECT_EQ(ec, std::errc::timed_out);
+    EXPECT_GE(ice::timer::clock::now() - start, std::chrono::milliseconds(20));
+
+    // The socket is still usable and an expired deadline does not affect later operations.
+    EXPECT_EQ(co_await socket.send("x", 1, ec), 1);
+    EXPECT_EQ(co_await client.recv(buffer.data(), buffer.size(), deadline(1000), ec), 1);
+    EXPECT_FALSE(ec);
+    client.close();
+  }();
+
+  t0.join();
+  server.close();
+}
+
+void cancel(bool uring)
+{
+  ice::net::service c0;
+  if (!create_service(c0, uring)) {
+    GTEST_SKIP() << "io_uring is not supported";
+  }
+
+  auto t0 = std::thread([&]() { c0.run(); });
+
+  ice::net::tcp::socket server{ c0 };
+  ice::net::tcp::socket client{ c0 };
+
+  [&]() -> ice::task {
+    co_await c0.schedule(true);
+    const auto ose = ice::on_scope_exit([&]() { c0.stop(); });
+
+    ice::net::endpoint ep;
+    EXPECT_FALSE(ep.create("127.0.0.1", 0));
+    EXPECT_FALSE(server.create(ep.family()));
+    EXPECT_FALSE(server.bind(ep));
+    EXPECT_FALSE(server.listen());
+    ep = server.name();
+
+    EXPECT_FALSE(client.create(ep.family()));
+    EXPECT_FALSE(co_await client.connect(ep));
+    ice::net::endpoint remote;
+    auto socket = co_await server.accept(remote);
+    EXPECT_TRUE(socket);
+
+    const auto deadline = ice::timer::time_point::max();
+    std::array<char, 64> buffer;
+    std::error_code ec;
+
+    // Cancellation requested from a foreign thread resumes the operation on the service thread.
+    ice::cancellation_source cs;
+    auto t1 = std::thread([&]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      cs.request_cancellation();
+    });
+    EXPECT_EQ(co_await client.recv(buffer.data(), buffer.size(), deadline, cs.token(), ec), 0);
+    EXPECT_EQ(ec, std::errc::operation_canceled);
+    EXPECT_EQ(std::this_thread::get_id(), t0.get_id());
+    t1.join();
+
+    // Operations with a token that is already canceled do not wait.
+    EXPECT_EQ(co_await client.recv(buffer.data(), buffer.size(), deadline, cs.token(), ec), 0);
+    EXPECT_EQ(ec, std::errc::operation_canceled);
+    EXPECT_FALSE(co_await server.accept(remote, deadline, cs.token()));
+
+    // The socket is still usable after a canceled wait.
+    ice::cancellation_source unused;
+    EXPECT_EQ(co_await socket.send("x", 1, ec), 1);
+    EXPECT_EQ(co_await client.recv(buffer.data(), buffer.size(), deadline, unused.token(), ec), 1);
+    EXPECT_FALSE(ec);
+    client.close();
+  }();
+
+  t0.join();
+  server.close();
+}
+
+void scatter_gather(bool uring)
+{
+  ice::net::service c0;
+  if (!create_service(c0, uring)) {
+    GTEST_SKIP() << "io_uring is not supported";
+  }
+
+  auto t0 = std::thread([&]() { c0.run(); });
+
+  ice::net::tcp::socket server{ c0 };
+  ice::net::tcp::socket client{ c0 };
+
+  [&]() -> ice::task {
+    co_await c0.schedule(true);
+    const auto ose = ice::on_scope_exit([&]() { c0.stop(); });
+
+    ice::net::endpoint ep;
+    EXPECT_FALSE(ep.create("127.0.0.1", 0));
+    EXPECT_FALSE(server.create(ep.family()));
+    EXPECT_FALSE(server.bind(ep));
+    EXPECT_FALSE(server.listen());
+    ep = server.name();
+
+    EXPECT_FALSE(client.create(ep.family()));
+    EXPECT_FALSE(co_await client.connect(ep));
+    ice::net::endpoint remote;
+    auto socket = co_await server.accept(remote);
+    EXPECT_TRUE(socket);
+
+    // The payload is larger than the socket buffers, so that the send operation has to continue partial writes.
+    constexpr std::string_view header = "header";
+    constexpr std::string_view trailer = "trailer";
+    std::vector<char> payload(4 * 1024 * 1024);
+    for (std::size_t i = 0; i < payload.size(); i++) {
+      payload[i] = static_cast<char>(i % 251);
+    }
+    const auto size = header.size() + payload.size() + trailer.size();
+
+    std::vector<char> received(size);
+    ice::async_manual_reset_event done;
+    const auto recv = [&]() -> ice::task {
+      std::error_code ec;
+      std::size_t offset = 0;
+      while (offset < size) {
+        const auto first = std::min<std::size_t>(size - offset, 7);
+        const std::array<ice::net::buffer, 3> buffers{
+          ice::net::buffer{ received.data() + offset, first },
+          ice::net::buffer{ received.data() + offset, 0 },
+          ice::net::buffer{ received.data() + offset + first, size - offset - first },
+        };
+        const auto rv = co_await socket.recv(buffers, ec);
+        if (ec || !rv) {
+          break;
+        }
+        offset += rv;
+      }
+      EXPECT_FALSE(ec);
+      EXPECT_EQ(offset, size);
+      done.set();
+    };
+    recv();
+
+    const std::array<ice::net::buffer, 4> buffers{
+      ice::net::buffer{ header.data(), header.size() },
+      ice::net::buffer{ payload.data(), payload.size() },
+      ice::net::buffer{},
+      ice::net::buffer{ trailer.data(), trailer.size() },
+    };
+    std::error_code ec;
+    EXPECT_EQ(co_await client.send(buffers, ec), size);
+    EXPECT_FALSE(ec);
+    co_await done.wait();
+
+    EXPECT_TRUE(std::equal(header.begin(), header.end(), received.begin()));
+    EXPECT_TRUE(std::equal(payload.begin(), payload.end(), received.begin() + header.size()));
+    EXPECT_TRUE(std::equal(trailer.begin(), trailer.end(), received.end() - trailer.size()));
+    client.close();
+  }();
+
+  t0.join();
+  server.close();
+}
+
+void send_file()
+{
+  // The file is larger than the socket buffers, so that the operation has to wait until the socket is writable.
+  std::vector<char> data(4 * 1024 * 1024);
+  for (std::size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>(i % 251);
+  }
+  const auto stream = std::tmpfile();
+  ASSERT_TRUE(stream);
+  EXPECT_EQ(std::fwrite(data.data(), 1, data.size(), stream), data.size());
+  EXPECT_EQ(std::fflush(stream), 0);
+#if ICE_OS_WIN32
+  const auto file = reinterpret_cast<ice::net::tcp::socket::file_handle>(::_get_osfhandle(::_fileno(stream)));
+#else
+  const auto file = ::fileno(stream);
+#endif
+
+  using ice::net::tcp::socket;
+  run([&](socket&, socket& client, socket& accepted) -> ice::async<void> {
+    constexpr std::size_t offset = 3;
+    std::vector<char> received(data.size() - offset);
+    ice::async_manual_reset_event done;
+    recv(accepted, received, done);
+
+    // The operation stops at the end of the file.
+    std::error_code ec;
+    EXPECT_EQ(co_await client.send_file(file, offset, data.size(), ec), received.size());
+    EXPECT_FALSE(ec);
+    co_await done.wait();
+    EXPECT_TRUE(std::equal(received.begin(), received.end(), data.begin() + offset));
+  });
+
+  std::fclose(stream);
+}
+
+void send_zerocopy()
+{
+  using ice::net::tcp::socket;
+  run([](socket&, socket& client, socket& accepted) -> ice::async<void> {
+    std::vector<char> data(4 * 1024 * 1024);
+    std::vector<char> received(data.size() * 2);
+    ice::async_manual_reset_event done;
+    recv(accepted, received, done);
+
+    // The buffer can be modified as soon as the operation completed.
+    std::error_code ec;
+    for (auto i = 0; i < 2; i++) {
+      std::fill(data.begin(), data.end(), static_cast<char>('a' + i));
+      EXPECT_EQ(co_await client.send_zerocopy(data.data(), data.size(), ec), data.size());
+      EXPECT_FALSE(ec);
+    }
+    co_await done.wait();
+    EXPECT_TRUE(std::all_of(received.begin(), received.begin() + data.size(), [](char c) { return c == 'a'; }));
+    EXPECT_TRUE(std::all_of(received.begin() + data.size(), received.end(), [](char c) { return c == 'b'; }));
+  });
+}
+
+void accept_batch()
+{
+  using ice::net::tcp::socket;
+  run([](socket& server, socket&, socket&) -> ice::async<void> {
+    const auto ep = server.name();
+    std::vector<socket> clients;
+    for (auto i = 0; i < 5; i++) {
+      auto& client = clients.emplace_back(server.service());
+      EXPECT_FALSE(client.create(ep.family()));
+      EXPECT_FALSE(co_await client.connect(ep));
+    }
+
+    // The backlog is drained up to the requested number of connections without waiting.
+    std::vector<socket> sockets;
+    std::error_code ec;
+    EXPECT_EQ(co_await server.accept(sockets, 3, ec), 3);
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(co_await server.accept(sockets, 16, ec), 2);
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(sockets.size(), 5);
+    EXPECT_TRUE(std::all_of(sockets.begin(), sockets.end(), [](const auto& socket) { return bool(socket); }));
+
+    // The operation waits when the backlog is empty.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+    EXPECT_EQ(co_await server.accept(sockets, 16, deadline, ec), 0);
+    EXPECT_EQ(ec, std::errc::timed_out);
+    EXPECT_EQ(sockets.size(), 5);
+  });
+}
+
+#if !ICE_OS_WIN32
+
+void listen_reuse_port()
+{
+  constexpr std::size_t connections = 16;
+
+  ice::net::service c0;
+  ice::net::service c1;
+  EXPECT_FALSE(c0.create());
+  EXPECT_FALSE(c1.create());
+
+  auto t0 = std::thread([&]() { c0.run(); });
+  auto t1 = std::thread([&]() { c1.run(); });
+
+  std::vector<ice::net::tcp::socket> servers;
+  const std::array<ice::net::service*, 2> services = { &c0, &c1 };
+  ice::net::endpoint ep;
+  EXPECT_FALSE(ep.create("127.0.0.1", 0));
+  EXPECT_FALSE(ice::net::tcp::listen(services, ep, servers));
+  EXPECT_EQ(servers.size(), 2);
+  EXPECT_NE(servers[0].name().port(), 0);
+  EXPECT_EQ(servers[0].name().port(), servers[1].name().port());
+  ep = servers[0].name();
+
+  [&]() -> ice::task {
+    co_await c0.schedule(true);
+    const auto ose = ice::on_scope_exit([&]() { c0.stop(); });
+
+    std::vector<ice::net::tcp::socket> clients;
+    for (std::size_t i = 0; i < connections; i++) {
+      auto& client = clients.emplace_back(c0);
+      EXPECT_FALSE(client.create(ep.family()));
+      EXPECT_FALSE(co_await client.connect(ep));
+    }
+
+    // Every connection is queued on exactly one of the listeners.
+    std::vector<ice::net::tcp::socket> sockets;
+    for (auto& server : servers) {
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+      std::error_code ec;
+      co_await server.accept(sockets, connections, deadline, ec);
+    }
+    EXPECT_EQ(sockets.size(), connections);
+  }();
+
+  t0.join();
+  c1.stop();
+  t1.join();
+  servers.clear();
+}
+
+#endif
+
+}  // namespace
+
+// Verifies that recv and send operations resume after the socket would block.
+TEST(socket, echo)
+{
+  echo(true);
+}
+
+// Verifies the readiness based fallback when io_uring is not used.
+TEST(socket, echo_epoll)
+{
+  echo(false);
+}
+
+// Verifies that connections are served by multiple threads that run the same service.
+TEST(socket, echo_threads)
+{
+  echo_threads(true);
+}
+
+// Verifies readiness based waits when multiple threads run the same service.
+TEST(socket, echo_threads_epoll)
+{
+  echo_threads(false);
+}
+
+// Verifies that operations with a deadline stop waiting when the deadline expires.
+TEST(socket, timeout)
+{
+  timeout(true);
+}
+
+// Verifies deadlines with readiness based waits.
+TEST(socket, timeout_epoll)
+{
+  timeout(false);
+}
+
+// Verifies that operations with a cancellation token stop waiting when cancellation is requested.
+TEST(socket, cancel)
+{
+  cancel(true);
+}
+
+// Verifies cancellation of readiness based waits.
+TEST(socket, cancel_epoll)
+{
+  cancel(false);
+}
+
+// Verifies that scatter/gather operations transfer all buffers in order.
+TEST(socket, scatter_gather)
+{
+  scatter_gather(true);
+}
+
+// Verifies scatter/gather operations with readiness based waits.
+TEST(socket, scatter_gather_epoll)
+{
+  scatter_gather(false);
+}
+
+// Verifies that files are sent from the given offset up to the end of the file.
+TEST(socket, send_file)
+{
+  send_file();
+}
+
+// Verifies that zero-copy sends complete once the kernel released the buffer.
+TEST(socket, send_zerocopy)
+{
+  send_zerocopy();
+}
+
+// Verifies that batched accepts drain the backlog in one call.
+TEST(socket, accept_batch)
+{
+  accept_batch();
+}
+
+#if !ICE_OS_WIN32
+
+// Verifies that listeners on multiple services share the port with SO_REUSEPORT.
+TEST(socket, listen_reuse_port)
+{
+  listen_reuse_port();
+}
+
+#endif
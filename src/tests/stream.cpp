@@ -0,0 +1,141 @@
+#include <ice/async.hpp>
+#include <ice/error.hpp>
+#include <ice/parser.hpp>
+#include <ice/stream.hpp>
+#include <ice/sync_wait.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstring>
+
+namespace {
+
+// Stream that returns the input in chunks of limited size and records the size of every send call.
+class memory_stream {
+public:
+  memory_stream(std::string input, std::size_t chunk) : input_(std::move(input)), chunk_(chunk) {}
+
+  ice::async<std::size_t> recv(char* data, std::size_t size, std::error_code& ec) noexcept
+  {
+    ec.clear();
+    size = std::min({ size, chunk_, input_.size() - offset_ });
+    std::memcpy(data, input_.data() + offset_, size);
+    offset_ += size;
+    recvs++;
+    co_return size;
+  }
+
+  ice::async<std::size_t> send(const char* data, std::size_t size, std::error_code& ec) noexcept
+  {
+    ec.clear();
+    output.append(data, size);
+    sends.push_back(size);
+    co_return size;
+  }
+
+  std::size_t recvs = 0;
+  std::vector<std::size_t> sends;
+  std::string output;
+
+private:
+  std::string input_;
+  std::size_t offset_ = 0;
+  std::size_t chunk_ = 0;
+};
+
+}  // namespace
+
+// Verifies that delimited and fixed size reads are served from the buffer and refill it as needed.
+TEST(stream, read)
+{
+  memory_stream stream{ "hello\nworld\nabc", 4 };
+  ice::buffered_stream buffered{ stream, 8 };
+
+  const auto test = [&]() -> ice::async<void> {
+    std::error_code ec;
+    EXPECT_EQ(co_await buffered.read_until('\n', ec), "hello\n");
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(co_await buffered.read_until('\n', ec), "world\n");
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(co_await buffered.peek(ec), "abc");
+    std::array<char, 3> data = {};
+    EXPECT_EQ(co_await buffered.read_exact(data.data(), data.size(), ec), 3);
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(std::string_view(data.data(), data.size()), "abc");
+    EXPECT_EQ(co_await buffered.read_until('\n', ec), "");
+    EXPECT_EQ(ec, ice::make_error_code(ice::errc::eof));
+    EXPECT_EQ(co_await buffered.read_exact(data.data(), data.size(), ec), 0);
+    EXPECT_EQ(ec, ice::make_error_code(ice::errc::eof));
+  };
+  ice::sync_wait(test());
+  EXPECT_EQ(stream.recvs, 6);
+}
+
+// Verifies that a delimiter that does not fit in the buffer is reported and that large reads bypass the buffer.
+TEST(stream, read_large)
+{
+  memory_stream stream{ "0123456789\n0123456789", 64 };
+  ice::buffered_stream buffered{ stream, 8 };
+
+  const auto test = [&]() -> ice::async<void> {
+    std::error_code ec;
+    EXPECT_EQ(co_await buffered.read_until('\n', ec), "");
+    EXPECT_EQ(ec, std::errc::no_buffer_space);
+    EXPECT_EQ(buffered.buffered(), "01234567");
+    buffered.consume(8);
+    std::array<char, 13> data = {};
+    EXPECT_EQ(co_await buffered.recv(data.data(), data.size(), ec), 13);
+    EXPECT_EQ(std::string_view(data.data(), data.size()), "89\n0123456789");
+    EXPECT_TRUE(buffered.buffered().empty());
+  };
+  ice::sync_wait(test());
+  EXPECT_EQ(stream.recvs, 2);
+}
+
+// Verifies that small writes are coalesced until the buffer is full or flushed.
+TEST(stream, send)
+{
+  memory_stream stream{ "", 1 };
+  ice::buffered_stream buffered{ stream, 8, 8 };
+
+  const auto test = [&]() -> ice::async<void> {
+    std::error_code ec;
+    EXPECT_EQ(co_await buffered.send("abc", 3, ec), 3);
+    EXPECT_EQ(co_await buffered.send("def", 3, ec), 3);
+    EXPECT_TRUE(stream.sends.empty());
+    EXPECT_EQ(co_await buffered.send("ghi", 3, ec), 3);
+    EXPECT_EQ(co_await buffered.send("0123456789", 10, ec), 10);
+    EXPECT_EQ(co_await buffered.send("jkl", 3, ec), 3);
+    EXPECT_FALSE(co_await buffered.flush());
+    EXPECT_FALSE(co_await buffered.flush());
+  };
+  ice::sync_wait(test());
+  EXPECT_EQ(stream.sends, (std::vector<std::size_t>{ 6, 3, 10, 3 }));
+  EXPECT_EQ(stream.output, "abcdefghi0123456789jkl");
+}
+
+// Verifies that the parser consumes buffered data up to the match and leaves the rest in the buffer.
+TEST(stream, parser)
+{
+  memory_stream stream{ "noise\nok\nrest", 5 };
+  ice::buffered_stream buffered{ stream };
+
+  ice::parser parser;
+  parser.add("ok", [](const std::smatch&, std::error_code&) -> ice::async_state {
+    co_return ice::state::done;
+  });
+
+  const auto test = [&]() -> ice::async<void> {
+    EXPECT_FALSE(co_await parser.run(buffered));
+    std::error_code ec;
+    EXPECT_EQ(co_await buffered.read_until('\n', ec), "\n");
+    std::array<char, 4> data = {};
+    EXPECT_EQ(co_await buffered.read_exact(data.data(), data.size(), ec), 4);
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(std::string_view(data.data(), data.size()), "rest");
+  };
+  ice::sync_wait(test());
+}
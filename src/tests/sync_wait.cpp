@@ -0,0 +1,47 @@
+#include <ice/async.hpp>
+#include <ice/sync_wait.hpp>
+#include <ice/thread_pool.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+// Verifies that sync_wait returns the result of tasks that complete synchronously.
+TEST(sync_wait, ready)
+{
+  const auto value = []() -> ice::async<int> {
+    co_return 1;
+  };
+  EXPECT_EQ(ice::sync_wait(value()), 1);
+
+  int object = 0;
+  const auto reference = [&]() -> ice::async<int&> {
+    co_return object;
+  };
+  EXPECT_EQ(&ice::sync_wait(reference()), &object);
+
+  const auto move = []() -> ice::async<std::unique_ptr<int>> {
+    co_return std::make_unique<int>(2);
+  };
+  const auto pointer = ice::sync_wait(move());
+  ASSERT_TRUE(pointer);
+  EXPECT_EQ(*pointer, 2);
+}
+
+// Verifies that sync_wait blocks until a task completes on another thread.
+TEST(sync_wait, thread_pool)
+{
+  ice::thread_pool pool;
+  EXPECT_FALSE(pool.create(2));
+
+  const auto id = std::this_thread::get_id();
+  const auto task = [&]() -> ice::async<void> {
+    co_await pool.schedule(true);
+    EXPECT_NE(std::this_thread::get_id(), id);
+  };
+  for (auto i = 0; i < 100; i++) {
+    ice::sync_wait(task());
+  }
+
+  pool.stop();
+  pool.join();
+}
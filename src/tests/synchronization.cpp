@@ -0,0 +1,170 @@
+#include <ice/async.hpp>
+#include <ice/synchronization.hpp>
+#include <ice/thread_pool.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+
+// Verifies that the semaphore limits the number of concurrent coroutines and resumes waiters on their scheduler.
+TEST(synchronization, semaphore)
+{
+  constexpr int count = 100;
+  constexpr int limit = 3;
+
+  ice::thread_pool pool;
+  EXPECT_FALSE(pool.create(4));
+
+  ice::async_semaphore semaphore{ limit };
+  std::atomic_int active = 0;
+  std::atomic_int done = 0;
+
+  const auto task = [&]() -> ice::task {
+    co_await pool.schedule(true);
+    co_await semaphore.acquire(pool);
+    EXPECT_TRUE(pool.is_current());
+    EXPECT_LE(active.fetch_add(1) + 1, limit);
+    co_await pool.schedule(true);
+    active.fetch_sub(1);
+    semaphore.release();
+    if (done.fetch_add(1) + 1 == count) {
+      pool.stop();
+    }
+  };
+  for (auto i = 0; i < count; i++) {
+    task();
+  }
+
+  pool.join();
+  EXPECT_EQ(done.load(), count);
+  EXPECT_EQ(semaphore.available(), limit);
+}
+
+// Verifies that a batched release resumes the waiters in FIFO order.
+TEST(synchronization, semaphore_release)
+{
+  ice::async_semaphore semaphore;
+  EXPECT_FALSE(semaphore.try_acquire());
+
+  int order = 0;
+  int resumed[4] = {};
+  const auto task = [&](int index) -> ice::task {
+    co_await semaphore.acquire();
+    resumed[index] = ++order;
+  };
+  for (auto i = 0; i < 4; i++) {
+    task(i);
+  }
+  EXPECT_EQ(order, 0);
+  semaphore.release(3);
+  EXPECT_EQ(order, 3);
+  EXPECT_EQ(resumed[0], 1);
+  EXPECT_EQ(resumed[1], 2);
+  EXPECT_EQ(resumed[2], 3);
+  EXPECT_EQ(resumed[3], 0);
+  semaphore.release(2);
+  EXPECT_EQ(resumed[3], 4);
+  EXPECT_EQ(semaphore.available(), 1);
+}
+
+// Verifies that the manual reset event resumes all waiters and stays set.
+TEST(synchronization, manual_reset_event)
+{
+  ice::async_manual_reset_event event;
+  EXPECT_FALSE(event.is_set());
+
+  int resumed = 0;
+  const auto task = [&]() -> ice::task {
+    co_await event.wait();
+    resumed++;
+  };
+  task();
+  task();
+  EXPECT_EQ(resumed, 0);
+  event.set();
+  EXPECT_EQ(resumed, 2);
+  EXPECT_TRUE(event.is_set());
+  task();
+  EXPECT_EQ(resumed, 3);
+  event.reset();
+  EXPECT_FALSE(event.is_set());
+  task();
+  EXPECT_EQ(resumed, 3);
+  event.set();
+  EXPECT_EQ(resumed, 4);
+}
+
+// Verifies that the auto reset event resumes one waiter per set.
+TEST(synchronization, auto_reset_event)
+{
+  ice::async_auto_reset_event event;
+
+  int resumed = 0;
+  const auto task = [&]() -> ice::task {
+    co_await event.wait();
+    resumed++;
+  };
+  task();
+  task();
+  event.set();
+  EXPECT_EQ(resumed, 1);
+  EXPECT_FALSE(event.is_set());
+  event.set();
+  EXPECT_EQ(resumed, 2);
+  event.set();
+  event.set();
+  EXPECT_TRUE(event.is_set());
+  task();
+  EXPECT_EQ(resumed, 3);
+  EXPECT_FALSE(event.is_set());
+}
+
+// Verifies that the latch resumes waiters once it was counted down to zero.
+TEST(synchronization, latch)
+{
+  ice::async_latch latch{ 3 };
+
+  bool resumed = false;
+  const auto task = [&]() -> ice::task {
+    co_await latch.wait();
+    resumed = true;
+  };
+  task();
+  latch.count_down();
+  latch.count_down();
+  EXPECT_FALSE(resumed);
+  EXPECT_FALSE(latch.is_ready());
+  latch.count_down();
+  EXPECT_TRUE(resumed);
+  EXPECT_TRUE(latch.is_ready());
+}
+
+// Verifies that the barrier releases all participants of a phase together and can be reused.
+TEST(synchronization, barrier)
+{
+  constexpr int participants = 4;
+  constexpr int phases = 100;
+
+  ice::thread_pool pool;
+  EXPECT_FALSE(pool.create(4));
+
+  ice::async_barrier barrier{ participants };
+  std::atomic_int arrived[phases] = {};
+  std::atomic_int done = 0;
+
+  const auto task = [&]() -> ice::task {
+    co_await pool.schedule(true);
+    for (auto i = 0; i < phases; i++) {
+      arrived[i].fetch_add(1);
+      co_await barrier.arrive_and_wait(pool);
+      EXPECT_EQ(arrived[i].load(), participants);
+    }
+    if (done.fetch_add(1) + 1 == participants) {
+      pool.stop();
+    }
+  };
+  for (auto i = 0; i < participants; i++) {
+    task();
+  }
+
+  pool.join();
+  EXPECT_EQ(done.load(), participants);
+}
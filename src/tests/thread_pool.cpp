@@ -0,0 +1,65 @@
+#include <ice/async.hpp>
+#include <ice/thread_pool.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Verifies that the schedule operation works.
+TEST(thread_pool, schedule)
+{
+  ice::thread_pool pool;
+  EXPECT_FALSE(pool.create(4));
+  EXPECT_EQ(pool.size(), 4);
+
+  std::atomic_bool done = false;
+  const auto task = [&]() -> ice::task {
+    EXPECT_FALSE(pool.is_current());
+    co_await pool.schedule();
+    EXPECT_TRUE(pool.is_current());
+    co_await pool.schedule();
+    EXPECT_TRUE(pool.is_current());
+    co_await pool.schedule(true);
+    EXPECT_TRUE(pool.is_current());
+    co_await pool.schedule_after(std::chrono::milliseconds(10));
+    EXPECT_TRUE(pool.is_current());
+    done.store(true, std::memory_order_release);
+    pool.stop();
+  };
+  task();
+
+  pool.join();
+  EXPECT_TRUE(done.load(std::memory_order_acquire));
+}
+
+// Verifies that coroutines scheduled on a worker are resumed exactly once.
+TEST(thread_pool, steal)
+{
+  constexpr std::size_t count = 100;
+  constexpr std::size_t tasks = 1000;
+
+  ice::thread_pool pool;
+  EXPECT_FALSE(pool.create(4));
+
+  std::atomic_size_t resumed = 0;
+  const auto task = [&]() -> ice::task {
+    co_await pool.schedule(true);
+    resumed.fetch_add(1, std::memory_order_relaxed);
+  };
+  const auto spawn = [&]() -> ice::task {
+    co_await pool.schedule();
+    for (std::size_t i = 0; i < tasks; i++) {
+      task();
+    }
+  };
+  for (std::size_t i = 0; i < count; i++) {
+    spawn();
+  }
+  while (resumed.load(std::memory_order_relaxed) < count * tasks) {
+    std::this_thread::yield();
+  }
+
+  pool.stop();
+  pool.join();
+  EXPECT_EQ(resumed.load(), count * tasks);
+}
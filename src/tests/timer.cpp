@@ -0,0 +1,55 @@
+#include <ice/timer.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Verifies that timers expire in order, never early and only when they were not removed.
+TEST(timer, wheel)
+{
+  struct entry : ice::timer {
+    entry() noexcept : ice::timer({}, [](ice::timer& timer) noexcept { static_cast<entry&>(timer).expired++; }) {}
+    int expired = 0;
+    bool removed = false;
+  };
+
+  ice::timer_wheel wheel;
+  const auto start = ice::timer::clock::now();
+
+  std::mt19937 random{ 0 };
+  std::uniform_int_distribution<std::int64_t> distribution{ 0, 3'600'000 };
+  std::vector<std::unique_ptr<entry>> entries(100'000);
+  for (auto& e : entries) {
+    e = std::make_unique<entry>();
+    e->expiry(start + std::chrono::milliseconds(distribution(random)));
+    wheel.insert(*e);
+  }
+  for (std::size_t i = 0; i < entries.size(); i += 3) {
+    EXPECT_TRUE(wheel.remove(*entries[i]));
+    EXPECT_FALSE(wheel.remove(*entries[i]));
+    entries[i]->removed = true;
+  }
+
+  auto now = start;
+  auto last = ice::timer::time_point::min();
+  while (wheel.size()) {
+    const auto deadline = wheel.deadline();
+    ASSERT_NE(deadline, ice::timer::time_point::max());
+    now = std::max(now, deadline);
+    for (auto timer = wheel.advance(now); timer; ) {
+      const auto next = ice::timer_wheel::next(timer);
+      EXPECT_LE(timer->expiry(), now);
+      EXPECT_LE(last, timer->expiry());
+      last = timer->expiry();
+      timer->expire();
+      timer = next;
+    }
+  }
+  EXPECT_EQ(wheel.deadline(), ice::timer::time_point::max());
+
+  for (const auto& e : entries) {
+    EXPECT_EQ(e->expired, e->removed ? 0 : 1);
+    EXPECT_FALSE(wheel.remove(*e));
+  }
+}
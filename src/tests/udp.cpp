@@ -0,0 +1,160 @@
+#include <ice/async.hpp>
+#include <ice/net/service.hpp>
+#include <ice/net/udp/socket.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Runs the test on a service thread and stops the service when it completed.
+template <typename Function>
+void run(Function function)
+{
+  ice::net::service c0;
+  EXPECT_FALSE(c0.create());
+
+  auto t0 = std::thread([&]() { c0.run(); });
+
+  ice::net::udp::socket server{ c0 };
+  ice::net::udp::socket client{ c0 };
+  ice::net::endpoint ep;
+  EXPECT_FALSE(ep.create("127.0.0.1", 0));
+  EXPECT_FALSE(server.create(ep.family()));
+  EXPECT_FALSE(server.bind(ep));
+  EXPECT_FALSE(client.create(ep.family()));
+  EXPECT_FALSE(client.bind(ep));
+
+  [&]() -> ice::task {
+    co_await c0.schedule(true);
+    const auto ose = ice::on_scope_exit([&]() { c0.stop(); });
+    co_await function(server, client, server.name());
+  }();
+
+  t0.join();
+}
+
+void send_recv()
+{
+  using ice::net::udp::socket;
+  run([](socket& server, socket& client, ice::net::endpoint ep) -> ice::async<void> {
+    std::array<char, 64> buffer;
+    ice::net::endpoint remote;
+    std::error_code ec;
+    for (auto i = 0; i < 10; i++) {
+      const auto data = std::to_string(i);
+      EXPECT_EQ(co_await client.send_to(data.data(), data.size(), ep, ec), data.size());
+      const auto size = co_await server.recv_from(buffer.data(), buffer.size(), remote, ec);
+      EXPECT_FALSE(ec);
+      EXPECT_EQ(std::string_view(buffer.data(), size), data);
+      EXPECT_EQ(remote.port(), client.name().port());
+    }
+
+    // Receive operations stop waiting when the deadline expires.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+    EXPECT_EQ(co_await server.recv_from(buffer.data(), buffer.size(), remote, deadline, ec), 0);
+    EXPECT_EQ(ec, std::errc::timed_out);
+  });
+}
+
+void batch()
+{
+  using ice::net::udp::socket;
+  run([](socket& server, socket& client, ice::net::endpoint ep) -> ice::async<void> {
+    constexpr std::size_t count = 100;
+
+    std::vector<std::string> data;
+    std::vector<ice::net::udp::datagram> send(count);
+    data.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+      data.push_back(std::to_string(i));
+      send[i].buffer = { data[i].data(), data[i].size() };
+      send[i].endpoint = ep;
+    }
+    std::error_code ec;
+    EXPECT_EQ(co_await client.send_to(send, ec), count);
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(send[count - 1].size, data[count - 1].size());
+
+    std::vector<std::array<char, 64>> buffers(count);
+    std::vector<ice::net::udp::datagram> recv(count);
+    for (std::size_t i = 0; i < count; i++) {
+      recv[i].buffer = { buffers[i].data(), buffers[i].size() };
+    }
+    std::size_t received = 0;
+    while (received < count) {
+      const auto size = co_await server.recv_from(std::span(recv).subspan(received), ec);
+      if (ec || !size) {
+        break;
+      }
+      received += size;
+    }
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(received, count);
+    for (std::size_t i = 0; i < received; i++) {
+      EXPECT_EQ(std::string_view(buffers[i].data(), recv[i].size), data[i]);
+      EXPECT_EQ(recv[i].endpoint.port(), client.name().port());
+    }
+  });
+}
+
+void segments()
+{
+  using ice::net::udp::socket;
+  run([](socket& server, socket& client, ice::net::endpoint ep) -> ice::async<void> {
+    // Generic receive offload is optional and datagrams are either coalesced or received separately.
+    server.gro();
+
+    std::string data;
+    for (auto i = 0; i < 1050; i++) {
+      data.push_back(static_cast<char>('a' + i / 100));
+    }
+    std::error_code ec;
+    EXPECT_EQ(co_await client.send_segments(data.data(), data.size(), 100, ep, ec), data.size());
+    EXPECT_FALSE(ec);
+
+    std::vector<char> buffer(data.size() * 2);
+    std::string received;
+    std::vector<std::size_t> sizes;
+    while (received.size() < data.size()) {
+      std::array<ice::net::udp::datagram, 1> datagrams;
+      datagrams[0].buffer = { buffer.data(), buffer.size() };
+      if (!co_await server.recv_from(datagrams, ec) || ec) {
+        break;
+      }
+      const auto& datagram = datagrams[0];
+      const auto segment_size = datagram.segment_size ? datagram.segment_size : datagram.size;
+      for (std::size_t offset = 0; offset < datagram.size; offset += segment_size) {
+        sizes.push_back(std::min(segment_size, datagram.size - offset));
+      }
+      received.append(buffer.data(), datagram.size);
+    }
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(received, data);
+    EXPECT_EQ(sizes, (std::vector<std::size_t>{ 100, 100, 100, 100, 100, 100, 100, 100, 100, 100, 50 }));
+  });
+}
+
+}  // namespace
+
+// Verifies that datagrams are received with the address of the sender.
+TEST(udp, send_recv)
+{
+  send_recv();
+}
+
+// Verifies that batched operations transfer more datagrams than fit in one system call in order.
+TEST(udp, batch)
+{
+  batch();
+}
+
+// Verifies that segmented sends arrive as datagrams of the segment size.
+TEST(udp, segments)
+{
+  segments();
+}
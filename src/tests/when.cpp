@@ -0,0 +1,103 @@
+#include <ice/async.hpp>
+#include <ice/cancellation.hpp>
+#include <ice/thread_pool.hpp>
+#include <ice/when.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Verifies that when_all resumes with the results of all tasks.
+TEST(when, all)
+{
+  ice::thread_pool pool;
+  EXPECT_FALSE(pool.create(4));
+
+  std::atomic_size_t calls = 0;
+  const auto value = [&](int value) -> ice::async<int> {
+    co_await pool.schedule(true);
+    co_return value;
+  };
+  const auto text = [&]() -> ice::async<std::string> {
+    co_return "text";
+  };
+  const auto none = [&]() -> ice::async<> {
+    co_await pool.schedule(true);
+    calls.fetch_add(1, std::memory_order_relaxed);
+  };
+
+  std::atomic_bool done = false;
+  const auto task = [&]() -> ice::task {
+    auto [a, b, c, d] = co_await ice::when_all(value(1), text(), none(), value(2));
+    EXPECT_EQ(a, 1);
+    EXPECT_EQ(b, "text");
+    EXPECT_EQ(d, 2);
+
+    std::vector<ice::async<int>> values;
+    for (auto i = 0; i < 100; i++) {
+      values.push_back(value(i));
+    }
+    const auto results = co_await ice::when_all(std::move(values));
+    EXPECT_EQ(results.size(), 100);
+    for (auto i = 0; i < 100; i++) {
+      EXPECT_EQ(results[i], i);
+    }
+
+    std::vector<ice::async<>> nones;
+    for (auto i = 0; i < 100; i++) {
+      nones.push_back(none());
+    }
+    co_await ice::when_all(std::move(nones));
+    EXPECT_EQ(calls.load(std::memory_order_relaxed), 101);
+
+    co_await ice::when_all(std::vector<ice::async<>>{});
+    done.store(true, std::memory_order_release);
+    pool.stop();
+  };
+  task();
+
+  pool.join();
+  EXPECT_TRUE(done.load(std::memory_order_acquire));
+}
+
+// Verifies that when_any resumes with the first result and cancels the other tasks.
+TEST(when, any)
+{
+  ice::thread_pool pool;
+  EXPECT_FALSE(pool.create(4));
+
+  const auto sleep = [&](int value, std::chrono::milliseconds duration, ice::cancellation_token token)
+    -> ice::async<int> {
+    if (co_await pool.schedule_after(duration, std::move(token))) {
+      co_return -value;
+    }
+    co_return value;
+  };
+
+  std::atomic_bool done = false;
+  const auto task = [&]() -> ice::task {
+    using namespace std::chrono_literals;
+    ice::cancellation_source source;
+    const auto start = ice::timer::clock::now();
+    const auto result = co_await ice::when_any(
+      source, sleep(1, 10s, source.token()), sleep(2, 10ms, source.token()), sleep(3, 10s, source.token()));
+    EXPECT_LT(ice::timer::clock::now() - start, 5s);
+    EXPECT_EQ(result.index, 1);
+    EXPECT_EQ(result.value, 2);
+
+    std::vector<ice::async<int>> values;
+    values.push_back(sleep(1, 20ms, {}));
+    values.push_back(sleep(2, 0ms, {}));
+    const auto first = co_await ice::when_any(std::move(values));
+    EXPECT_EQ(first.index, 1);
+    EXPECT_EQ(first.value, 2);
+
+    done.store(true, std::memory_order_release);
+    pool.stop();
+  };
+  task();
+
+  pool.join();
+  EXPECT_TRUE(done.load(std::memory_order_acquire));
+}